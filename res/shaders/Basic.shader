@@ -26,6 +26,10 @@ uniform sampler2D u_Texture;
 
 void main()
 {
+#ifdef FLAT_COLOR
+    color = u_Color;
+#else
     vec4 texColor = texture(u_Texture, v_TexCoord);
     color = texColor;
+#endif
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+layout(location = 2) in vec4 color;
+layout(location = 3) in float layer;
+
+out vec2 v_TexCoord;
+out vec4 v_Color;
+flat out float v_Layer;
+
+// Shared by every shader that draws with the camera, filled once per frame by a uniform buffer
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+};
+
+void main()
+{
+   gl_Position = u_ViewProjection * position;
+   v_TexCoord = texCoord;
+   v_Color = color;
+   v_Layer = layer;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+flat in float v_Layer;
+
+uniform sampler2DArray u_Textures;
+
+void main()
+{
+    color = texture(u_Textures, vec3(v_TexCoord, v_Layer)) * v_Color;
+};
\ No newline at end of file
@@ -0,0 +1,28 @@
+#shader vertex
+#version 330 core
+
+#include "Fullscreen.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Texture;
+uniform vec2 u_Direction; // One texel along the axis to blur
+
+void main()
+{
+    // A 9 tap gaussian along a single axis, run twice for a full blur
+    float weights[5] = float[](0.227027, 0.1945946, 0.1216216, 0.054054, 0.016216);
+
+    vec4 sum = texture(u_Texture, v_TexCoord) * weights[0];
+    for (int i = 1; i < 5; i++)
+    {
+        sum += texture(u_Texture, v_TexCoord + u_Direction * i) * weights[i];
+        sum += texture(u_Texture, v_TexCoord - u_Direction * i) * weights[i];
+    }
+    color = sum;
+};
\ No newline at end of file
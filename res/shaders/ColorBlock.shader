@@ -0,0 +1,37 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+};
+
+// The values of a single draw, bound from a ring of per draw values
+layout(std140) uniform Draw
+{
+    mat4 u_Model;
+    vec4 u_Color;
+};
+
+void main()
+{
+   gl_Position = u_ViewProjection * u_Model * position;
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+layout(std140) uniform Draw
+{
+    mat4 u_Model;
+    vec4 u_Color;
+};
+
+void main()
+{
+    color = u_Color;
+};
\ No newline at end of file
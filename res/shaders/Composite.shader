@@ -0,0 +1,19 @@
+#shader vertex
+#version 330 core
+
+#include "Fullscreen.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec2 v_TexCoord;
+
+uniform sampler2D u_Scene;
+uniform sampler2D u_Bloom;
+
+void main()
+{
+    color = texture(u_Scene, v_TexCoord) + texture(u_Bloom, v_TexCoord);
+};
\ No newline at end of file
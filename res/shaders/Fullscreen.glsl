@@ -0,0 +1,12 @@
+// The vertex stage of a fullscreen pass, include it after the #version line
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec2 texCoord;
+
+out vec2 v_TexCoord;
+
+void main()
+{
+   gl_Position = position; // A fullscreen quad in clip space
+   v_TexCoord = texCoord;
+};
\ No newline at end of file
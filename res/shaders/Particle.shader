@@ -0,0 +1,30 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 particle; // per instance, the position and velocity that ParticleUpdate wrote
+
+out vec4 v_Color;
+
+uniform mat4 u_ViewProjection;
+
+void main()
+{
+   gl_Position = u_ViewProjection * vec4(particle.xy + corner, 0.0, 1.0);
+
+   // Slow particles are blue, fast ones are orange
+   float speed = clamp(length(particle.zw) / 300.0, 0.0, 1.0);
+   v_Color = vec4(mix(vec3(0.2, 0.4, 1.0), vec3(1.0, 0.5, 0.2), speed), 1.0);
+};
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+};
\ No newline at end of file
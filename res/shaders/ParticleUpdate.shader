@@ -0,0 +1,42 @@
+#shader compute
+#version 430 core
+
+layout(local_size_x = 256) in;
+
+struct Particle
+{
+    vec2 Position;
+    vec2 Velocity;
+};
+
+layout(std430) buffer Particles
+{
+    Particle particles[];
+};
+
+uniform float u_DeltaTime;
+uniform vec2 u_Attractor;
+uniform int u_Count;
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= uint(u_Count))
+        return;
+
+    Particle particle = particles[index];
+
+    // Pull towards the attractor, damp the velocity and bounce off the edges of the window
+    vec2 toAttractor = u_Attractor - particle.Position;
+    particle.Velocity += normalize(toAttractor + vec2(0.001)) * 200.0 * u_DeltaTime;
+    particle.Velocity *= 0.995;
+    particle.Position += particle.Velocity * u_DeltaTime;
+
+    if (particle.Position.x < 0.0 || particle.Position.x > 960.0)
+        particle.Velocity.x = -particle.Velocity.x;
+    if (particle.Position.y < 0.0 || particle.Position.y > 540.0)
+        particle.Velocity.y = -particle.Velocity.y;
+    particle.Position = clamp(particle.Position, vec2(0.0), vec2(960.0, 540.0));
+
+    particles[index] = particle;
+};
\ No newline at end of file
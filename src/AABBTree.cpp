@@ -0,0 +1,464 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Renderer.h"
+
+/**
+The cost of a box for the surface area heuristic. The sum of the edges is used instead of the area,
+flat 2D quads have no volume and lines have no area, but both still have edges.
+*/
+static float Cost(const glm::vec3& min, const glm::vec3& max)
+{
+    glm::vec3 size = max - min;
+    return size.x + size.y + size.z;
+}
+
+static bool Overlaps(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB)
+{
+    return minA.x <= maxB.x && maxA.x >= minB.x &&
+           minA.y <= maxB.y && maxA.y >= minB.y &&
+           minA.z <= maxB.z && maxA.z >= minB.z;
+}
+
+static bool Contains(const glm::vec3& outerMin, const glm::vec3& outerMax, const glm::vec3& innerMin, const glm::vec3& innerMax)
+{
+    return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && outerMin.z <= innerMin.z &&
+           outerMax.x >= innerMax.x && outerMax.y >= innerMax.y && outerMax.z >= innerMax.z;
+}
+
+/**
+Test a box against all planes of a frustum.
+
+@return -1 when the box is outside, 1 when it is completely inside and 0 when it intersects the frustum
+*/
+static int Classify(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max)
+{
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 extent = (max - min) * 0.5f;
+    int result = 1;
+
+    for (const auto& plane : frustum.Planes)
+    {
+        glm::vec3 normal(plane);
+        float distance = glm::dot(normal, center) + plane.w;
+        float radius = glm::dot(glm::abs(normal), extent);
+
+        if (distance + radius < 0.0f)
+            return -1;
+        if (distance - radius < 0.0f)
+            result = 0;
+    }
+
+    return result;
+}
+
+/**
+Slab test of a ray against a box.
+*/
+static bool RayHits(const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, const glm::vec3& min, const glm::vec3& max)
+{
+    float entry = 0.0f;
+    float exit = maxDistance;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float t1 = (min[axis] - origin[axis]) * inverseDirection[axis];
+        float t2 = (max[axis] - origin[axis]) * inverseDirection[axis];
+        entry = std::max(entry, std::min(t1, t2));
+        exit = std::min(exit, std::max(t1, t2));
+    }
+
+    return entry <= exit;
+}
+
+AABBTree::AABBTree(float margin)
+    : m_Root(Null), m_FreeList(Null), m_LeafCount(0), m_Margin(margin)
+{
+}
+
+int AABBTree::Insert(const glm::vec3& min, const glm::vec3& max, unsigned int userData)
+{
+    int leaf = AllocateNode();
+    Node& node = m_Nodes[leaf];
+    node.Min = min - m_Margin;
+    node.Max = max + m_Margin;
+    node.ObjectMin = min;
+    node.ObjectMax = max;
+    node.UserData = userData;
+    node.Height = 0;
+
+    InsertLeaf(leaf);
+    m_LeafCount++;
+    return leaf;
+}
+
+int AABBTree::InsertQuad(const glm::vec2& position, const glm::vec2& size, unsigned int userData)
+{
+    return Insert(glm::vec3(position, 0.0f), glm::vec3(position + size, 0.0f), userData);
+}
+
+void AABBTree::Remove(int proxy)
+{
+    ASSERT(proxy >= 0 && proxy < (int)m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0);
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_LeafCount--;
+}
+
+bool AABBTree::Move(int proxy, const glm::vec3& min, const glm::vec3& max)
+{
+    ASSERT(proxy >= 0 && proxy < (int)m_Nodes.size() && m_Nodes[proxy].IsLeaf() && m_Nodes[proxy].Height == 0);
+
+    Node& node = m_Nodes[proxy];
+    node.ObjectMin = min;
+    node.ObjectMax = max;
+
+    // Still inside of the fattened box, the tree stays valid
+    if (Contains(node.Min, node.Max, min, max))
+        return false;
+
+    RemoveLeaf(proxy);
+    m_Nodes[proxy].Min = min - m_Margin;
+    m_Nodes[proxy].Max = max + m_Margin;
+    InsertLeaf(proxy);
+    return true;
+}
+
+void AABBTree::QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& visible) const
+{
+    if (m_Root == Null)
+        return;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+        const Node& node = m_Nodes[index];
+
+        int result = Classify(frustum, node.Min, node.Max);
+        if (result < 0)
+            continue;
+
+        // Everything below a node that is completely inside is visible, no need to test it
+        if (result > 0)
+        {
+            CollectLeaves(index, visible);
+            continue;
+        }
+
+        if (node.IsLeaf())
+        {
+            if (Classify(frustum, node.ObjectMin, node.ObjectMax) >= 0)
+                visible.push_back(node.UserData);
+            continue;
+        }
+
+        stack.push_back(node.Child1);
+        stack.push_back(node.Child2);
+    }
+}
+
+void AABBTree::QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<unsigned int>& results) const
+{
+    if (m_Root == Null)
+        return;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+
+    while (!stack.empty())
+    {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+
+        if (!Overlaps(node.Min, node.Max, min, max))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            if (Overlaps(node.ObjectMin, node.ObjectMax, min, max))
+                results.push_back(node.UserData);
+            continue;
+        }
+
+        stack.push_back(node.Child1);
+        stack.push_back(node.Child2);
+    }
+}
+
+void AABBTree::QueryRect(const glm::vec2& min, const glm::vec2& max, std::vector<unsigned int>& results) const
+{
+    // Every depth, so quads at any z are found
+    QueryBox(glm::vec3(min, -INFINITY), glm::vec3(max, INFINITY), results);
+}
+
+void AABBTree::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<unsigned int>& hits) const
+{
+    if (m_Root == Null)
+        return;
+
+    glm::vec3 inverseDirection = 1.0f / direction;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+
+    while (!stack.empty())
+    {
+        const Node& node = m_Nodes[stack.back()];
+        stack.pop_back();
+
+        if (!RayHits(origin, inverseDirection, maxDistance, node.Min, node.Max))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            if (RayHits(origin, inverseDirection, maxDistance, node.ObjectMin, node.ObjectMax))
+                hits.push_back(node.UserData);
+            continue;
+        }
+
+        stack.push_back(node.Child1);
+        stack.push_back(node.Child2);
+    }
+}
+
+int AABBTree::AllocateNode()
+{
+    int index;
+
+    if (m_FreeList == Null)
+    {
+        m_Nodes.emplace_back();
+        index = (int)m_Nodes.size() - 1;
+    }
+    else
+    {
+        index = m_FreeList;
+        m_FreeList = m_Nodes[index].Parent;
+    }
+
+    Node& node = m_Nodes[index];
+    node.Parent = Null;
+    node.Child1 = Null;
+    node.Child2 = Null;
+    node.Height = 0;
+    node.UserData = 0;
+    return index;
+}
+
+void AABBTree::FreeNode(int node)
+{
+    m_Nodes[node].Parent = m_FreeList;
+    m_Nodes[node].Height = -1;
+    m_FreeList = node;
+}
+
+void AABBTree::InsertLeaf(int leaf)
+{
+    if (m_Root == Null)
+    {
+        m_Root = leaf;
+        m_Nodes[leaf].Parent = Null;
+        return;
+    }
+
+    glm::vec3 leafMin = m_Nodes[leaf].Min;
+    glm::vec3 leafMax = m_Nodes[leaf].Max;
+
+    // Walk down to the sibling that increases the total cost of the tree the least
+    int index = m_Root;
+    while (!m_Nodes[index].IsLeaf())
+    {
+        const Node& node = m_Nodes[index];
+        float cost = Cost(node.Min, node.Max);
+        float combinedCost = Cost(glm::min(node.Min, leafMin), glm::max(node.Max, leafMax));
+
+        // Cost of pairing with this node, and the cost every ancestor pays to grow around the leaf
+        float pairCost = 2.0f * combinedCost;
+        float inheritedCost = 2.0f * (combinedCost - cost);
+
+        float childCosts[2];
+        for (int i = 0; i < 2; i++)
+        {
+            const Node& child = m_Nodes[i == 0 ? node.Child1 : node.Child2];
+            childCosts[i] = Cost(glm::min(child.Min, leafMin), glm::max(child.Max, leafMax)) + inheritedCost;
+            if (!child.IsLeaf())
+                childCosts[i] -= Cost(child.Min, child.Max);
+        }
+
+        if (pairCost < childCosts[0] && pairCost < childCosts[1])
+            break;
+
+        index = childCosts[0] < childCosts[1] ? node.Child1 : node.Child2;
+    }
+
+    int sibling = index;
+    int oldParent = m_Nodes[sibling].Parent;
+    int newParent = AllocateNode();
+
+    Node& parent = m_Nodes[newParent];
+    parent.Parent = oldParent;
+    parent.Min = glm::min(leafMin, m_Nodes[sibling].Min);
+    parent.Max = glm::max(leafMax, m_Nodes[sibling].Max);
+    parent.Height = m_Nodes[sibling].Height + 1;
+    parent.Child1 = sibling;
+    parent.Child2 = leaf;
+    m_Nodes[sibling].Parent = newParent;
+    m_Nodes[leaf].Parent = newParent;
+
+    if (oldParent == Null)
+        m_Root = newParent;
+    else if (m_Nodes[oldParent].Child1 == sibling)
+        m_Nodes[oldParent].Child1 = newParent;
+    else
+        m_Nodes[oldParent].Child2 = newParent;
+
+    // Refit and rebalance the ancestors
+    index = m_Nodes[leaf].Parent;
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        const Node& child1 = m_Nodes[node.Child1];
+        const Node& child2 = m_Nodes[node.Child2];
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+        node.Min = glm::min(child1.Min, child2.Min);
+        node.Max = glm::max(child1.Max, child2.Max);
+
+        index = node.Parent;
+    }
+}
+
+void AABBTree::RemoveLeaf(int leaf)
+{
+    if (leaf == m_Root)
+    {
+        m_Root = Null;
+        return;
+    }
+
+    int parent = m_Nodes[leaf].Parent;
+    int grandParent = m_Nodes[parent].Parent;
+    int sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+    // The sibling takes the place of the parent
+    FreeNode(parent);
+    m_Nodes[sibling].Parent = grandParent;
+
+    if (grandParent == Null)
+    {
+        m_Root = sibling;
+        return;
+    }
+
+    if (m_Nodes[grandParent].Child1 == parent)
+        m_Nodes[grandParent].Child1 = sibling;
+    else
+        m_Nodes[grandParent].Child2 = sibling;
+
+    int index = grandParent;
+    while (index != Null)
+    {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        const Node& child1 = m_Nodes[node.Child1];
+        const Node& child2 = m_Nodes[node.Child2];
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+        node.Min = glm::min(child1.Min, child2.Min);
+        node.Max = glm::max(child1.Max, child2.Max);
+
+        index = node.Parent;
+    }
+}
+
+int AABBTree::Balance(int a)
+{
+    Node& nodeA = m_Nodes[a];
+    if (nodeA.IsLeaf() || nodeA.Height < 2)
+        return a;
+
+    int b = nodeA.Child1;
+    int c = nodeA.Child2;
+    int balance = m_Nodes[c].Height - m_Nodes[b].Height;
+
+    if (balance >= -1 && balance <= 1)
+        return a;
+
+    // The higher child moves up into the place of a, a becomes its child
+    bool rotateRight = balance > 1;
+    int up = rotateRight ? c : b;
+    int stay = rotateRight ? b : c;
+
+    Node& nodeUp = m_Nodes[up];
+    int f = nodeUp.Child1;
+    int g = nodeUp.Child2;
+
+    nodeUp.Child1 = a;
+    nodeUp.Parent = nodeA.Parent;
+    nodeA.Parent = up;
+
+    if (nodeUp.Parent == Null)
+        m_Root = up;
+    else if (m_Nodes[nodeUp.Parent].Child1 == a)
+        m_Nodes[nodeUp.Parent].Child1 = up;
+    else
+        m_Nodes[nodeUp.Parent].Child2 = up;
+
+    // The higher grandchild stays with the node that moved up, the other one goes to a
+    int high = m_Nodes[f].Height > m_Nodes[g].Height ? f : g;
+    int low = high == f ? g : f;
+
+    nodeUp.Child2 = high;
+    if (rotateRight)
+        nodeA.Child2 = low;
+    else
+        nodeA.Child1 = low;
+    m_Nodes[low].Parent = a;
+
+    const Node& nodeStay = m_Nodes[stay];
+    const Node& nodeLow = m_Nodes[low];
+    const Node& nodeHigh = m_Nodes[high];
+
+    nodeA.Min = glm::min(nodeStay.Min, nodeLow.Min);
+    nodeA.Max = glm::max(nodeStay.Max, nodeLow.Max);
+    nodeA.Height = 1 + std::max(nodeStay.Height, nodeLow.Height);
+
+    nodeUp.Min = glm::min(nodeA.Min, nodeHigh.Min);
+    nodeUp.Max = glm::max(nodeA.Max, nodeHigh.Max);
+    nodeUp.Height = 1 + std::max(nodeA.Height, nodeHigh.Height);
+
+    return up;
+}
+
+void AABBTree::CollectLeaves(int node, std::vector<unsigned int>& results) const
+{
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(node);
+
+    while (!stack.empty())
+    {
+        const Node& current = m_Nodes[stack.back()];
+        stack.pop_back();
+
+        if (current.IsLeaf())
+        {
+            results.push_back(current.UserData);
+            continue;
+        }
+
+        stack.push_back(current.Child1);
+        stack.push_back(current.Child2);
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+
+#include "FrustumCuller.h"
+
+#include "glm/glm.hpp"
+
+/**
+A dynamic bounding volume hierarchy over the bounds of renderable objects, for culling and picking.
+Every leaf stores a fattened box, so an object that moves a little doesn't have to be reinserted.
+*/
+class AABBTree
+{
+private:
+    static const int Null = -1;
+
+    struct Node
+    {
+        glm::vec3 Min, Max; // Fattened by the margin for leaves
+        glm::vec3 ObjectMin, ObjectMax; // The exact bounds of the object, only used by leaves
+        int Parent; // The next free node while the node is unused
+        int Child1, Child2;
+        int Height; // 0 for leaves, -1 for free nodes
+        unsigned int UserData;
+
+        inline bool IsLeaf() const { return Child1 == Null; }
+    };
+
+    std::vector<Node> m_Nodes;
+    int m_Root;
+    int m_FreeList;
+    unsigned int m_LeafCount;
+    float m_Margin;
+public:
+    /**
+        Create an empty tree.
+
+        @param margin The amount every leaf box is fattened on all sides, objects that move less than this are not reinserted
+    */
+    AABBTree(float margin = 4.0f);
+
+    /**
+        Add the bounds of an object.
+
+        @param min The minimum corner of the bounds
+        @param max The maximum corner of the bounds
+        @param userData Returned by the queries when the object is found, like an index into a list of sprites
+        @return The proxy of the object, to move or remove it later
+    */
+    int Insert(const glm::vec3& min, const glm::vec3& max, unsigned int userData);
+
+    /**
+        Add the bounds of a 2D quad, like the ones given to BatchRenderer::DrawQuad.
+    */
+    int InsertQuad(const glm::vec2& position, const glm::vec2& size, unsigned int userData);
+
+    void Remove(int proxy);
+
+    /**
+        Update the bounds of an object, it is only reinserted when the new bounds leave its fattened box.
+
+        @return True when the object was reinserted
+    */
+    bool Move(int proxy, const glm::vec3& min, const glm::vec3& max);
+
+    /**
+        Find every object whose bounds intersect the frustum, in no particular order.
+
+        @param visible The user data of the objects is appended to this list
+    */
+    void QueryFrustum(const Frustum& frustum, std::vector<unsigned int>& visible) const;
+
+    /**
+        Find every object whose bounds overlap the box, pass the same point as min and max to pick at a point.
+    */
+    void QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<unsigned int>& results) const;
+
+    /**
+        Find every object whose bounds overlap a 2D rectangle, like a selection rectangle in screen space.
+    */
+    void QueryRect(const glm::vec2& min, const glm::vec2& max, std::vector<unsigned int>& results) const;
+
+    /**
+        Find every object whose bounds are hit by a ray.
+
+        @param origin The start of the ray
+        @param direction The direction of the ray, doesn't have to be normalized
+        @param maxDistance The length of the ray in multiples of direction
+        @param hits The user data of the objects is appended to this list
+    */
+    void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, std::vector<unsigned int>& hits) const;
+
+    inline unsigned int GetUserData(int proxy) const { return m_Nodes[proxy].UserData; }
+    inline unsigned int GetCount() const { return m_LeafCount; }
+    inline int GetHeight() const { return m_Root == Null ? 0 : m_Nodes[m_Root].Height; }
+private:
+    int AllocateNode();
+    void FreeNode(int node);
+
+    void InsertLeaf(int leaf);
+    void RemoveLeaf(int leaf);
+
+    /**
+        Rotate the tree around a node when one of its children is more than one level higher than the other.
+
+        @return The node that took its place
+    */
+    int Balance(int node);
+
+    /**
+        Append the user data of every leaf below a node, without testing their bounds.
+    */
+    void CollectLeaves(int node, std::vector<unsigned int>& results) const;
+};
\ No newline at end of file
@@ -14,14 +14,18 @@
 #include "VertexArray.h"
 #include "Shader.h"
 #include "Texture.h"
+#include "Benchmark.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 
-int main(void)
+int main(int argc, char** argv)
 {
     GLFWwindow* window;
 
+    // Run the benchmarks instead of the demo with: --bench [name]
+    bool benchmark = argc > 1 && std::string(argv[1]) == "--bench";
+
     // Initialize the library
     if (!glfwInit())
         return -1;
@@ -31,6 +35,10 @@ int main(void)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    // Benchmarks render offscreen so they can run headless
+    if (benchmark)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
     // Create a windowed mode window and its OpenGL context
     window = glfwCreateWindow(960, 540, "Hello World", NULL, NULL);
     if (!window)
@@ -43,7 +51,7 @@ int main(void)
     glfwMakeContextCurrent(window);
 
     // Synchronize the refresh rate with our native refresh rate
-    glfwSwapInterval(1);
+    glfwSwapInterval(benchmark ? 0 : 1);
     
     // Initialize Glew
     if (glewInit() != GLEW_OK)
@@ -52,6 +60,19 @@ int main(void)
     // Log the OpenGL version used because we can
     std::cout << glGetString(GL_VERSION) << std::endl;
 
+    if (benchmark)
+    {
+        GLCall(glEnable(GL_BLEND));
+        GLCall(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+
+        std::string name = argc > 2 ? argv[2] : "all";
+        if (!RunBenchmarks(name))
+            std::cout << "Unknown benchmark: " << name << std::endl;
+
+        glfwTerminate();
+        return 0;
+    }
+
     {
         // Create and select (bind) the data & buffer for drawing
         float positions[] =
@@ -105,6 +126,9 @@ int main(void)
 
         Renderer renderer;
 
+        // Hashed at compile time, so the loop doesn't hash the name every frame
+        constexpr UniformName colorUniform("u_Color");
+
         // Animation stuff
         float r = 0.0f;
         float increment = 0.05f;
@@ -115,7 +139,7 @@ int main(void)
             renderer.Clear();
 
             shader.Bind();
-            shader.SetUniform4f("u_Color", r, 0.3f, 0.8f, 1.0f);
+            shader.SetUniform4f(colorUniform, r, 0.3f, 0.8f, 1.0f);
 
             renderer.Draw(va, ib, shader);
 
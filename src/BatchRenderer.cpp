@@ -0,0 +1,169 @@
+#include "BatchRenderer.h"
+#include "VertexBufferLayout.h"
+#include "Renderer.h"
+
+/**
+Create the indices for the given amount of quads, every quad uses the vertices bottom-left, bottom-right, top-right and top-left.
+*/
+static std::vector<unsigned int> CreateQuadIndices(unsigned int quadCount)
+{
+    std::vector<unsigned int> indices(quadCount * 6);
+
+    for (unsigned int i = 0; i < quadCount; i++)
+    {
+        unsigned int offset = i * 4;
+        indices[i * 6 + 0] = offset + 0;
+        indices[i * 6 + 1] = offset + 1;
+        indices[i * 6 + 2] = offset + 2;
+        indices[i * 6 + 3] = offset + 2;
+        indices[i * 6 + 4] = offset + 3;
+        indices[i * 6 + 5] = offset + 0;
+    }
+
+    return indices;
+}
+
+BatchRenderer::BatchRenderer(unsigned int maxQuads)
+    : m_MaxQuads(maxQuads),
+      m_VertexBuffer(maxQuads * 4 * sizeof(BatchVertex)), // A region per batch
+      m_IndexBuffer(CreateQuadIndices(maxQuads).data(), maxQuads * 6),
+      m_Shader("res/shaders/Batch.shader"),
+      m_ArrayShader("res/shaders/BatchArray.shader"),
+      m_Vertices(nullptr),
+      m_QuadCount(0),
+      m_TextureSlotCount(0),
+      m_TextureArray(nullptr),
+      m_CameraBuffer("Camera", sizeof(glm::mat4))
+{
+    VertexBufferLayout layout;
+    layout.Push<float>(2); // position
+    layout.Push<float>(2); // texcoord
+    layout.Push<float>(4); // color
+    layout.Push<float>(1); // texture index
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+
+    // Every sampler in the array reads from the texture unit with the same index
+    int samplers[MaxTextureSlots];
+    for (unsigned int i = 0; i < MaxTextureSlots; i++)
+        samplers[i] = i;
+
+    ASSERT(m_Shader.GetUniformBlock("Camera") && m_Shader.GetUniformBlock("Camera")->Size == m_CameraBuffer.GetSize());
+    ASSERT(m_Shader.ValidateVertexArray(m_VertexArray) && m_ArrayShader.ValidateVertexArray(m_VertexArray));
+
+    m_Shader.Bind();
+    m_Shader.SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+    m_ArrayShader.Bind();
+    m_ArrayShader.SetUniform1i("u_Textures", 0);
+    m_ArrayShader.Unbind();
+    m_VertexArray.Unbind();
+}
+
+void BatchRenderer::BeginBatch(const glm::mat4& viewProjection, const TextureArray* textureArray)
+{
+    // Uploaded once for every flush and both shaders, instead of a uniform per program per flush
+    m_CameraBuffer.Set(0, viewProjection);
+    m_CameraBuffer.Upload();
+    m_TextureArray = textureArray;
+    m_QuadCount = 0;
+    m_TextureSlotCount = 0;
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, const Texture* texture)
+{
+    DrawQuad(position, size, color, texture, { 0.0f, 0.0f }, { 1.0f, 1.0f });
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, const Texture* texture, const glm::vec2& uvMin, const glm::vec2& uvMax)
+{
+    ASSERT(!m_TextureArray); // A texture array batch only draws layer quads
+
+    if (m_QuadCount == m_MaxQuads)
+        Flush();
+
+    float texIndex = -1.0f;
+
+    if (texture)
+    {
+        // Reuse the slot if the texture is already part of this batch
+        for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+        {
+            if (m_TextureSlots[i] == texture)
+            {
+                texIndex = (float)i;
+                break;
+            }
+        }
+
+        if (texIndex < 0.0f)
+        {
+            if (m_TextureSlotCount == MaxTextureSlots)
+                Flush();
+
+            texIndex = (float)m_TextureSlotCount;
+            m_TextureSlots[m_TextureSlotCount++] = texture;
+        }
+    }
+
+    AddQuad(position, size, color, texIndex, uvMin, uvMax);
+}
+
+void BatchRenderer::DrawLayerQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, unsigned int layer)
+{
+    ASSERT(m_TextureArray && layer < m_TextureArray->GetLayerCount());
+
+    if (m_QuadCount == m_MaxQuads)
+        Flush();
+
+    AddQuad(position, size, color, (float)layer, { 0.0f, 0.0f }, { 1.0f, 1.0f });
+}
+
+void BatchRenderer::AddQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, float texIndex, const glm::vec2& uvMin, const glm::vec2& uvMax)
+{
+    // The vertices are written straight into the buffer, there's no copy to upload
+    if (!m_Vertices)
+        m_Vertices = (BatchVertex*)m_VertexBuffer.Map(m_MaxQuads * 4 * sizeof(BatchVertex), sizeof(BatchVertex));
+
+    BatchVertex* vertex = &m_Vertices[m_QuadCount * 4];
+    vertex[0] = { { position.x,          position.y          }, { uvMin.x, uvMin.y }, color, texIndex }; // bottom-left
+    vertex[1] = { { position.x + size.x, position.y          }, { uvMax.x, uvMin.y }, color, texIndex }; // bottom-right
+    vertex[2] = { { position.x + size.x, position.y + size.y }, { uvMax.x, uvMax.y }, color, texIndex }; // top-right
+    vertex[3] = { { position.x,          position.y + size.y }, { uvMin.x, uvMax.y }, color, texIndex }; // top-left
+
+    m_QuadCount++;
+}
+
+void BatchRenderer::EndBatch()
+{
+    Flush();
+}
+
+void BatchRenderer::Flush()
+{
+    if (m_QuadCount == 0)
+        return;
+
+    unsigned int firstVertex = m_VertexBuffer.Unmap(m_QuadCount * 4 * sizeof(BatchVertex), sizeof(BatchVertex));
+    m_Vertices = nullptr;
+
+    // A texture array batch only needs the array, whatever layers the quads use
+    Shader& shader = m_TextureArray ? m_ArrayShader : m_Shader;
+    if (m_TextureArray)
+        m_TextureArray->Bind(0);
+
+    for (unsigned int i = 0; i < m_TextureSlotCount; i++)
+        m_TextureSlots[i]->Bind(i);
+
+    shader.Bind();
+    m_CameraBuffer.Bind();
+    m_VertexArray.Bind();
+    m_IndexBuffer.Bind();
+
+    // Only draw the part of the index buffer that is used by this batch, starting at the vertices it wrote
+    GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, m_QuadCount * 6, m_IndexBuffer.GetType(), nullptr, firstVertex));
+
+    m_Stats.DrawCalls++;
+    m_Stats.QuadCount += m_QuadCount;
+
+    m_QuadCount = 0;
+    m_TextureSlotCount = 0;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+
+#include "VertexArray.h"
+#include "StreamBuffer.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+#include "TextureArray.h"
+#include "UniformBuffer.h"
+
+#include "glm/glm.hpp"
+
+/**
+A single vertex of a batched quad. Position and texcoord come first so they use the same locations as in Basic.shader.
+*/
+struct BatchVertex
+{
+    glm::vec2 Position;
+    glm::vec2 TexCoord;
+    glm::vec4 Color;
+    float TexIndex; // -1 for a plain colored quad, the layer when drawing from a texture array
+};
+
+/**
+Statistics about the batches that were flushed since the last reset.
+*/
+struct BatchStats
+{
+    unsigned int DrawCalls = 0;
+    unsigned int QuadCount = 0;
+};
+
+class BatchRenderer
+{
+private:
+    static const unsigned int MaxTextureSlots = 16; // The minimum amount of fragment texture units OpenGL 3.3 guarantees
+
+    unsigned int m_MaxQuads;
+    VertexArray m_VertexArray;
+    StreamBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    Shader m_Shader;
+    Shader m_ArrayShader;
+
+    BatchVertex* m_Vertices; // Mapped buffer memory while quads are added, nullptr otherwise
+    unsigned int m_QuadCount;
+
+    const Texture* m_TextureSlots[MaxTextureSlots];
+    unsigned int m_TextureSlotCount;
+    const TextureArray* m_TextureArray;
+
+    UniformBuffer m_CameraBuffer; // The Camera block of the batch shaders
+    BatchStats m_Stats;
+public:
+    /**
+        Create the buffers for a batch renderer.
+
+        @param maxQuads The amount of quads a single draw call can hold
+    */
+    BatchRenderer(unsigned int maxQuads = 10000);
+
+    /**
+        Start collecting quads for the given camera.
+
+        @param viewProjection The view projection matrix used for all quads in this batch
+        @param textureArray The texture array all quads of the batch draw from with DrawLayerQuad, or nullptr to draw with textures
+    */
+    void BeginBatch(const glm::mat4& viewProjection, const TextureArray* textureArray = nullptr);
+
+    /**
+        Add a quad to the batch, flushes the batch first when it's full.
+
+        @param position The bottom-left corner of the quad
+        @param size The width and height of the quad
+        @param color The color, multiplied with the texture if there is one
+        @param texture The texture of the quad or nullptr for a plain colored quad
+    */
+    void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, const Texture* texture = nullptr);
+
+    /**
+        Add a quad that shows part of a texture, like a sprite in an atlas.
+
+        @param position The bottom-left corner of the quad
+        @param size The width and height of the quad
+        @param color The color, multiplied with the texture
+        @param texture The texture of the quad
+        @param uvMin The texture coordinate of the bottom-left corner
+        @param uvMax The texture coordinate of the top-right corner
+    */
+    void DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, const Texture* texture, const glm::vec2& uvMin, const glm::vec2& uvMax);
+
+    /**
+        Add a quad that shows a layer of the texture array of the batch, any layer can be mixed in a single draw call.
+
+        @param position The bottom-left corner of the quad
+        @param size The width and height of the quad
+        @param color The color, multiplied with the texture
+        @param layer The layer of the texture array
+    */
+    void DrawLayerQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, unsigned int layer);
+
+    /**
+        Draw all quads that are left in the batch.
+    */
+    void EndBatch();
+
+    inline const BatchStats& GetStats() const { return m_Stats; }
+    inline void ResetStats() { m_Stats = BatchStats(); }
+    inline const StreamBuffer& GetVertexBuffer() const { return m_VertexBuffer; }
+private:
+
+    /**
+        Draw the collected quads with a single draw call.
+    */
+    void Flush();
+
+    /**
+        Write the vertices of a quad at the end of the batch.
+    */
+    void AddQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color, float texIndex, const glm::vec2& uvMin, const glm::vec2& uvMax);
+};
\ No newline at end of file
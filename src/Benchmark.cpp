@@ -0,0 +1,1322 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Renderer.h"
+#include "BatchRenderer.h"
+#include "RenderQueue.h"
+#include "InstanceBuffer.h"
+#include "ThreadPool.h"
+#include "FrameGraph.h"
+#include "TextureArray.h"
+#include "FrustumCuller.h"
+#include "AABBTree.h"
+#include "StreamBuffer.h"
+#include "UniformBuffer.h"
+#include "UniformRingBuffer.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "ShaderVariantCache.h"
+#include "MappedFile.h"
+#include "ShaderStorageBuffer.h"
+#include "TextureLoader.h"
+#include "VertexBufferLayout.h"
+#include "Texture.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+/**
+Measure the average time of a frame, including the time the GPU needs to finish it.
+
+@param frames The amount of frames to average over
+@param frame The function that renders a single frame
+@return The average frame time in milliseconds
+*/
+static double MeasureFrameTime(unsigned int frames, const std::function<void()>& frame)
+{
+    // Warm up once so buffer allocations and shader compilation are not measured
+    frame();
+    GLCall(glFinish());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < frames; i++)
+    {
+        frame();
+        GLCall(glFinish());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / frames;
+}
+
+/**
+Random positions inside of the 960x540 window, seeded so every run draws the same scene.
+*/
+static std::vector<glm::vec2> CreatePositions(unsigned int count)
+{
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> x(0.0f, 960.0f);
+    std::uniform_real_distribution<float> y(0.0f, 540.0f);
+
+    std::vector<glm::vec2> positions(count);
+    for (auto& position : positions)
+        position = { x(random), y(random) };
+
+    return positions;
+}
+
+static void BenchmarkBatchRenderer()
+{
+    Renderer renderer;
+    BatchRenderer batch;
+    Texture texture("res/textures/ChernoLogo.png");
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+
+    std::cout << std::setw(10) << "quads" << std::setw(12) << "draw calls" << std::setw(16) << "frame (ms)" << std::endl;
+
+    for (unsigned int quadCount : { 10000u, 100000u, 1000000u })
+    {
+        std::vector<glm::vec2> positions = CreatePositions(quadCount);
+
+        double frameTime = MeasureFrameTime(10, [&]()
+        {
+            renderer.Clear();
+            batch.ResetStats();
+            batch.BeginBatch(proj);
+
+            // Mix textured and plain quads, like a typical sprite scene
+            for (unsigned int i = 0; i < quadCount; i++)
+                batch.DrawQuad(positions[i], { 4.0f, 4.0f }, { 1.0f, 0.5f, 0.2f, 1.0f }, i % 2 ? &texture : nullptr);
+
+            batch.EndBatch();
+        });
+
+        std::cout << std::setw(10) << quadCount << std::setw(12) << batch.GetStats().DrawCalls << std::setw(16) << std::fixed << std::setprecision(3) << frameTime << std::endl;
+    }
+}
+
+static void BenchmarkRenderQueue()
+{
+    float positions[] =
+    {
+        100.0f, 100.0f, 0.0f, 0.0f,
+        200.0f, 100.0f, 1.0f, 0.0f,
+        200.0f, 200.0f, 1.0f, 1.0f,
+        100.0f, 200.0f, 0.0f, 1.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexBuffer vb(positions, 4 * 4 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+
+    // A few of each kind of state, submitted interleaved like an unsorted scene would
+    VertexArray vertexArrays[4];
+    for (auto& va : vertexArrays)
+        va.AddBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+
+    Shader shaders[2] = { { "res/shaders/Basic.shader" }, { "res/shaders/Basic.shader" } };
+    Texture textures[2] = { { "res/textures/ChernoLogo.png" }, { "res/textures/ChernoLogo.png" } };
+
+    glm::mat4 mvp = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    for (auto& shader : shaders)
+    {
+        shader.Bind();
+        shader.SetUniformMat4f("u_MVP", mvp);
+        shader.SetUniform1i("u_Texture", 0);
+    }
+
+    Renderer renderer;
+    RenderQueue queue;
+    const unsigned int commandCount = 10000;
+
+    double frameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+
+        for (unsigned int i = 0; i < commandCount; i++)
+            queue.Submit(vertexArrays[i % 4], ib, shaders[i % 2], &textures[(i / 2) % 2], 0, (i % 100) / 100.0f);
+
+        queue.Flush();
+    });
+
+    const RenderQueueStats& stats = queue.GetStats();
+    std::cout << "commands: " << stats.Commands << ", state changes submitted: " << stats.SubmittedStateChanges
+        << ", sorted: " << stats.SortedStateChanges << ", saved: " << stats.GetSavedStateChanges()
+        << ", frame (ms): " << std::fixed << std::setprecision(3) << frameTime << std::endl;
+}
+
+static void BenchmarkInstancing()
+{
+    // A unit quad that every instance scales and moves with its transform
+    float positions[] =
+    {
+        0.0f, 0.0f, 0.0f, 0.0f,
+        1.0f, 0.0f, 1.0f, 0.0f,
+        1.0f, 1.0f, 1.0f, 1.0f,
+        0.0f, 1.0f, 0.0f, 1.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+    const unsigned int instanceCount = 100000;
+
+    VertexArray va;
+    VertexBuffer vb(positions, 4 * 4 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    va.AddBuffer(vb, layout);
+
+    InstanceBuffer instances(instanceCount);
+    instances.AddTo(va);
+
+    IndexBuffer ib(indices, 6);
+    Shader shader("res/shaders/Instanced.shader");
+    Texture texture("res/textures/ChernoLogo.png");
+    Renderer renderer;
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    shader.Bind();
+    shader.SetUniformMat4f("u_ViewProjection", proj);
+    shader.SetUniform1i("u_Texture", 0);
+    texture.Bind();
+
+    std::vector<glm::vec2> offsets = CreatePositions(instanceCount);
+
+    double frameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+
+        instances.Clear();
+        for (const auto& offset : offsets)
+            instances.Add(glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(offset, 0.0f)), glm::vec3(4.0f, 4.0f, 1.0f)), { 1.0f, 0.5f, 0.2f, 1.0f });
+        instances.Upload();
+
+        renderer.DrawInstanced(va, ib, shader, instances.GetCount());
+    });
+
+    std::cout << "instances: " << instanceCount << ", draw calls: 1, frame (ms): " << std::fixed << std::setprecision(3) << frameTime << std::endl;
+}
+
+static void BenchmarkMultiDrawIndirect()
+{
+    const unsigned int meshCount = 10000;
+    std::vector<glm::vec2> offsets = CreatePositions(meshCount);
+
+    Shader shader("res/shaders/Basic.shader");
+    Texture texture("res/textures/ChernoLogo.png");
+    Renderer renderer;
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    shader.Bind();
+    shader.SetUniformMat4f("u_MVP", proj);
+    shader.SetUniform1i("u_Texture", 0);
+    texture.Bind();
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+
+    // Every mesh has its own vertices and indices, like distinct meshes would
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    for (const auto& offset : offsets)
+    {
+        float quad[] =
+        {
+            offset.x,        offset.y,        0.0f, 0.0f,
+            offset.x + 4.0f, offset.y,        1.0f, 0.0f,
+            offset.x + 4.0f, offset.y + 4.0f, 1.0f, 1.0f,
+            offset.x,        offset.y + 4.0f, 0.0f, 1.0f,
+        };
+        vertices.insert(vertices.end(), quad, quad + 16);
+
+        unsigned int quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+        indices.insert(indices.end(), quadIndices, quadIndices + 6);
+    }
+
+    // The per object path, a vertex array and buffers per mesh
+    std::vector<std::unique_ptr<VertexArray>> objectArrays;
+    std::vector<std::unique_ptr<VertexBuffer>> objectVertexBuffers;
+    std::vector<std::unique_ptr<IndexBuffer>> objectIndexBuffers;
+    for (unsigned int i = 0; i < meshCount; i++)
+    {
+        objectArrays.emplace_back(new VertexArray());
+        objectVertexBuffers.emplace_back(new VertexBuffer(&vertices[i * 16], 16 * sizeof(float)));
+        objectArrays.back()->AddBuffer(*objectVertexBuffers.back(), layout);
+        objectIndexBuffers.emplace_back(new IndexBuffer(&indices[i * 6], 6));
+    }
+
+    double objectFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+        for (unsigned int i = 0; i < meshCount; i++)
+            renderer.Draw(*objectArrays[i], *objectIndexBuffers[i], shader);
+    });
+
+    // The indirect path, all meshes in shared buffers
+    VertexArray va;
+    VertexBuffer vb(vertices.data(), (unsigned int)(vertices.size() * sizeof(float)));
+    va.AddBuffer(vb, layout);
+    IndexBuffer ib(indices.data(), (unsigned int)indices.size());
+    IndirectBuffer commands;
+
+    double indirectFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+
+        commands.Clear();
+        for (unsigned int i = 0; i < meshCount; i++)
+            commands.Add(6, i * 6, i * 4);
+        commands.Upload(ib.GetType());
+
+        renderer.MultiDrawIndirect(va, ib, shader, commands);
+    });
+
+    std::cout << "meshes: " << meshCount << std::fixed << std::setprecision(3)
+        << ", per object draw (ms): " << objectFrameTime
+        << ", " << (commands.IsIndirect() ? "glMultiDrawElementsIndirect" : "glMultiDrawElementsBaseVertex") << " (ms): " << indirectFrameTime << std::endl;
+}
+
+static void BenchmarkParallelRecording()
+{
+    float positions[] =
+    {
+        0.0f, 0.0f, 0.0f, 0.0f,
+        4.0f, 0.0f, 1.0f, 0.0f,
+        4.0f, 4.0f, 1.0f, 1.0f,
+        0.0f, 4.0f, 0.0f, 1.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexArray va;
+    VertexBuffer vb(positions, 4 * 4 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    va.AddBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+    Shader shader("res/shaders/Basic.shader");
+    Texture texture("res/textures/ChernoLogo.png");
+
+    // Spread the objects over twice the screen size in each axis, so about a quarter is visible and three quarters are culled
+    const unsigned int objectCount = 1000000;
+    std::vector<glm::vec2> objects = CreatePositions(objectCount);
+    for (auto& object : objects)
+        object = object * 2.0f - glm::vec2(480.0f, 270.0f);
+
+    glm::mat4 viewProjection = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+
+    // The per object work that doesn't need the context: culling, depth and key generation
+    auto record = [&](unsigned int begin, unsigned int end, RenderCommandBuffer& buffer)
+    {
+        for (unsigned int i = begin; i < end; i++)
+        {
+            glm::vec4 clip = viewProjection * glm::vec4(objects[i], 0.0f, 1.0f);
+            if (clip.x < -1.0f || clip.x > 1.0f || clip.y < -1.0f || clip.y > 1.0f)
+                continue;
+
+            buffer.Submit(va, ib, shader, &texture, 0, clip.y * 0.5f + 0.5f);
+        }
+    };
+
+    RenderQueue queue;
+    ThreadPool pool;
+    std::vector<RenderCommandBuffer> buffers(pool.GetThreadCount());
+
+    auto measure = [&](const std::function<void()>& build)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        build();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    double singleThreaded = measure([&]()
+    {
+        record(0, objectCount, buffers[0]);
+        queue.Merge(buffers[0]);
+    });
+    queue.Flush();
+
+    double multiThreaded = measure([&]()
+    {
+        pool.ParallelFor(objectCount, [&](unsigned int begin, unsigned int end, unsigned int chunk)
+        {
+            record(begin, end, buffers[chunk]);
+        });
+
+        // Back on the thread that owns the context, merge in worker order so the result is deterministic
+        for (auto& buffer : buffers)
+            queue.Merge(buffer);
+    });
+    queue.Flush();
+
+    std::cout << "objects: " << objectCount << ", visible: " << queue.GetStats().Commands << std::fixed << std::setprecision(3)
+        << ", build 1 thread (ms): " << singleThreaded
+        << ", build " << pool.GetThreadCount() << " threads (ms): " << multiThreaded << std::endl;
+}
+
+static void BenchmarkFrameGraph()
+{
+    float positions[] =
+    {
+        -1.0f, -1.0f, 0.0f, 0.0f,
+         1.0f, -1.0f, 1.0f, 0.0f,
+         1.0f,  1.0f, 1.0f, 1.0f,
+        -1.0f,  1.0f, 0.0f, 1.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexArray fullscreen;
+    VertexBuffer vb(positions, 4 * 4 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    fullscreen.AddBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+
+    Shader blur("res/shaders/Blur.shader");
+    Shader composite("res/shaders/Composite.shader");
+    Texture texture("res/textures/ChernoLogo.png");
+    BatchRenderer batch;
+    Renderer renderer;
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    std::vector<glm::vec2> sprites = CreatePositions(10000);
+    FrameGraphTextureDesc desc = { 960, 540, GL_RGBA8 };
+    FrameGraph graph;
+
+    double frameTime = MeasureFrameTime(10, [&]()
+    {
+        graph.Reset();
+
+        FrameGraphResource backbuffer = graph.ImportBackbuffer(960, 540);
+        FrameGraphResource scene = graph.CreateTexture("Scene", desc);
+        FrameGraphResource debug = graph.CreateTexture("Debug", desc);
+
+        graph.AddPass("Scene", [&](const FrameGraph&)
+        {
+            batch.BeginBatch(proj);
+            for (const auto& sprite : sprites)
+                batch.DrawQuad(sprite, { 4.0f, 4.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, &texture);
+            batch.EndBatch();
+        }).Write(scene);
+
+        // Blur twice, the targets of the second iteration alias the ones of the first
+        FrameGraphResource bloom = scene;
+        for (unsigned int i = 0; i < 2; i++)
+        {
+            for (const glm::vec2& direction : { glm::vec2(1.0f / 960.0f, 0.0f), glm::vec2(0.0f, 1.0f / 540.0f) })
+            {
+                FrameGraphResource source = bloom;
+                bloom = graph.CreateTexture("Blur", desc);
+
+                FrameGraphPass& blurPass = graph.AddPass("Blur", [&, source, direction](const FrameGraph& graph)
+                {
+                    graph.GetTexture(source).Bind();
+                    blur.Bind();
+                    blur.SetUniform1i("u_Texture", 0);
+                    blur.SetUniform2f("u_Direction", direction.x, direction.y);
+                    renderer.Draw(fullscreen, ib, blur);
+                });
+                blurPass.Read(source);
+                blurPass.Write(bloom);
+            }
+        }
+
+        // Nothing reads the debug view, so the graph culls this pass
+        FrameGraphPass& debugPass = graph.AddPass("Debug", [&](const FrameGraph&) {});
+        debugPass.Read(scene);
+        debugPass.Write(debug);
+
+        FrameGraphPass& compositePass = graph.AddPass("Composite", [&](const FrameGraph& graph)
+        {
+            graph.GetTexture(scene).Bind(0);
+            graph.GetTexture(bloom).Bind(1);
+            composite.Bind();
+            composite.SetUniform1i("u_Scene", 0);
+            composite.SetUniform1i("u_Bloom", 1);
+            renderer.Draw(fullscreen, ib, composite);
+        });
+        compositePass.Read(scene);
+        compositePass.Read(bloom);
+        compositePass.Write(backbuffer);
+
+        graph.Compile();
+        graph.Execute();
+    });
+
+    const FrameGraphStats& stats = graph.GetStats();
+    std::cout << "passes executed: " << stats.PassesExecuted << ", culled: " << stats.PassesCulled
+        << ", transient textures: " << stats.TransientTextures << " (" << stats.TransientBytes / 1024 << " KB)"
+        << ", physical textures: " << stats.PhysicalTextures << " (" << stats.PhysicalBytes / 1024 << " KB)"
+        << ", frame (ms): " << std::fixed << std::setprecision(3) << frameTime << std::endl;
+}
+
+static void BenchmarkTextureArray()
+{
+    const unsigned int imageCount = 256;
+    const unsigned int quadCount = 100000;
+    const int imageSize = 16;
+
+    // Give every image its own solid color so they are distinct
+    std::vector<std::unique_ptr<Texture>> textures;
+    TextureArray textureArray(imageSize, imageSize, imageCount);
+    std::vector<unsigned char> pixels(imageSize * imageSize * 4);
+    for (unsigned int i = 0; i < imageCount; i++)
+    {
+        for (unsigned int p = 0; p < pixels.size(); p += 4)
+        {
+            pixels[p + 0] = (unsigned char)i;
+            pixels[p + 1] = (unsigned char)(255 - i);
+            pixels[p + 2] = (unsigned char)(i * 7);
+            pixels[p + 3] = 255;
+        }
+
+        textures.emplace_back(new Texture(imageSize, imageSize));
+        textures.back()->SetData(pixels.data());
+        textureArray.AddLayer(pixels.data());
+    }
+
+    Renderer renderer;
+    BatchRenderer batch;
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    std::vector<glm::vec2> positions = CreatePositions(quadCount);
+
+    double textureFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+        batch.ResetStats();
+        batch.BeginBatch(proj);
+        for (unsigned int i = 0; i < quadCount; i++)
+            batch.DrawQuad(positions[i], { 4.0f, 4.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, textures[i % imageCount].get());
+        batch.EndBatch();
+    });
+    unsigned int textureDrawCalls = batch.GetStats().DrawCalls;
+
+    double arrayFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+        batch.ResetStats();
+        batch.BeginBatch(proj, &textureArray);
+        for (unsigned int i = 0; i < quadCount; i++)
+            batch.DrawLayerQuad(positions[i], { 4.0f, 4.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, i % imageCount);
+        batch.EndBatch();
+    });
+
+    std::cout << "quads: " << quadCount << ", images: " << imageCount << std::fixed << std::setprecision(3)
+        << ", textures: " << textureDrawCalls << " draw calls " << textureFrameTime << " ms"
+        << ", texture array: " << batch.GetStats().DrawCalls << " draw calls " << arrayFrameTime << " ms" << std::endl;
+}
+
+static void BenchmarkCulling()
+{
+    const unsigned int objectCount = 1000000;
+
+    // Spread the objects over a world three times the size of the screen, so most of them are culled
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> x(-960.0f, 1920.0f);
+    std::uniform_real_distribution<float> y(-540.0f, 1080.0f);
+    std::uniform_real_distribution<float> size(1.0f, 16.0f);
+
+    AABBList boxes;
+    for (unsigned int i = 0; i < objectCount; i++)
+        boxes.AddQuad({ x(random), y(random) }, { size(random), size(random) });
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    Frustum frustum = Frustum::FromMatrix(proj);
+    ThreadPool pool;
+    std::vector<unsigned int> visible;
+    visible.reserve(objectCount);
+
+    auto measure = [](unsigned int runs, const std::function<void()>& cull)
+    {
+        cull();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned int i = 0; i < runs; i++)
+            cull();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / runs;
+    };
+
+    // The reference: one box at a time against the screen rectangle
+    double scalarTime = measure(10, [&]()
+    {
+        visible.clear();
+        for (unsigned int i = 0; i < objectCount; i++)
+        {
+            if (boxes.CenterX[i] + boxes.ExtentX[i] >= 0.0f && boxes.CenterX[i] - boxes.ExtentX[i] <= 960.0f &&
+                boxes.CenterY[i] + boxes.ExtentY[i] >= 0.0f && boxes.CenterY[i] - boxes.ExtentY[i] <= 540.0f)
+                visible.push_back(i);
+        }
+    });
+    size_t scalarVisible = visible.size();
+
+    double simdTime = measure(10, [&]() { FrustumCuller::Cull(frustum, boxes, visible); });
+    size_t simdVisible = visible.size();
+
+    double parallelTime = measure(10, [&]() { FrustumCuller::Cull(frustum, boxes, visible, &pool); });
+    ASSERT(visible.size() == scalarVisible && simdVisible == scalarVisible);
+
+    std::cout << "objects: " << objectCount << ", visible: " << visible.size() << std::fixed << std::setprecision(3)
+        << ", scalar: " << scalarTime << " ms"
+        << ", simd: " << simdTime << " ms"
+        << ", simd on " << pool.GetThreadCount() << " threads: " << parallelTime << " ms" << std::endl;
+}
+
+static void BenchmarkSpatialIndex()
+{
+    const unsigned int objectCount = 1000000;
+    const unsigned int movingCount = 10000;
+
+    // A world ten times the size of the screen in both directions, the camera sees about one percent of it
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> x(-4800.0f, 5760.0f);
+    std::uniform_real_distribution<float> y(-2700.0f, 3240.0f);
+    std::uniform_real_distribution<float> size(1.0f, 16.0f);
+    std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+
+    std::vector<glm::vec3> mins(objectCount), maxs(objectCount);
+    AABBList boxes;
+    for (unsigned int i = 0; i < objectCount; i++)
+    {
+        mins[i] = { x(random), y(random), 0.0f };
+        maxs[i] = mins[i] + glm::vec3(size(random), size(random), 0.0f);
+        boxes.Add(mins[i], maxs[i]);
+    }
+
+    auto measure = [](unsigned int runs, const std::function<void()>& work)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (unsigned int i = 0; i < runs; i++)
+            work();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count() / runs;
+    };
+
+    AABBTree tree;
+    std::vector<int> proxies(objectCount);
+    double buildTime = measure(1, [&]()
+    {
+        for (unsigned int i = 0; i < objectCount; i++)
+            proxies[i] = tree.Insert(mins[i], maxs[i], i);
+    });
+
+    // Move the first objects a little every frame, most of them stay inside of their fattened box
+    unsigned int reinserted = 0;
+    double moveTime = measure(10, [&]()
+    {
+        for (unsigned int i = 0; i < movingCount; i++)
+        {
+            glm::vec3 offset(step(random), step(random), 0.0f);
+            mins[i] += offset;
+            maxs[i] += offset;
+            boxes.CenterX[i] += offset.x;
+            boxes.CenterY[i] += offset.y;
+            reinserted += tree.Move(proxies[i], mins[i], maxs[i]);
+        }
+    });
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    Frustum frustum = Frustum::FromMatrix(proj);
+    std::vector<unsigned int> visible;
+    visible.reserve(objectCount);
+
+    double bruteForceTime = measure(10, [&]() { FrustumCuller::Cull(frustum, boxes, visible); });
+    size_t bruteForceVisible = visible.size();
+
+    double treeTime = measure(10, [&]() { visible.clear(); tree.QueryFrustum(frustum, visible); });
+
+    // Picking under the mouse with a one pixel rectangle
+    std::vector<unsigned int> picked;
+    double pickTime = measure(1000, [&]() { picked.clear(); tree.QueryRect({ 480.0f, 270.0f }, { 481.0f, 271.0f }, picked); });
+
+    std::cout << "objects: " << objectCount << ", height: " << tree.GetHeight() << std::fixed << std::setprecision(3)
+        << ", build: " << buildTime << " ms"
+        << ", moving " << movingCount << ": " << moveTime << " ms (" << reinserted / 10 << " reinserted)"
+        << ", brute force: " << bruteForceVisible << " visible " << bruteForceTime << " ms"
+        << ", tree: " << visible.size() << " visible " << treeTime << " ms"
+        << ", pick: " << pickTime * 1000.0 << " us" << std::endl;
+}
+
+static void BenchmarkStreaming()
+{
+    const unsigned int quadCount = 100000;
+    const unsigned int chunkQuads = 10000;
+    const unsigned int chunkSize = chunkQuads * 4 * 4 * sizeof(float);
+
+    std::vector<unsigned int> indices(chunkQuads * 6);
+    for (unsigned int i = 0; i < chunkQuads; i++)
+    {
+        unsigned int quad[] = { 0, 1, 2, 2, 3, 0 };
+        for (unsigned int j = 0; j < 6; j++)
+            indices[i * 6 + j] = i * 4 + quad[j];
+    }
+    IndexBuffer ib(indices.data(), (unsigned int)indices.size());
+
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+
+    VertexBuffer orphanBuffer(chunkSize);
+    VertexArray orphanVA;
+    orphanVA.AddBuffer(orphanBuffer, layout);
+
+    StreamBuffer streamBuffer(chunkSize);
+    VertexArray streamVA;
+    streamVA.AddBuffer(streamBuffer, layout);
+
+    Renderer renderer;
+    Shader shader("res/shaders/Basic.shader");
+    Texture texture("res/textures/ChernoLogo.png");
+    texture.Bind();
+    shader.Bind();
+    shader.SetUniform1i("u_Texture", 0);
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    shader.SetUniformMat4f("u_MVP", proj);
+
+    std::vector<glm::vec2> positions = CreatePositions(quadCount);
+    float time = 0.0f;
+
+    auto writeQuads = [&](float* vertices, unsigned int first)
+    {
+        for (unsigned int i = 0; i < chunkQuads; i++)
+        {
+            glm::vec2 position = positions[first + i] + glm::vec2(std::sin(time + i), 0.0f);
+            float quad[] =
+            {
+                position.x,        position.y,        0.0f, 0.0f,
+                position.x + 4.0f, position.y,        1.0f, 0.0f,
+                position.x + 4.0f, position.y + 4.0f, 1.0f, 1.0f,
+                position.x,        position.y + 4.0f, 0.0f, 1.0f,
+            };
+            std::copy(quad, quad + 16, vertices + i * 16);
+        }
+    };
+
+    // The old way: build the vertices in memory, then orphan and copy them into the buffer
+    std::vector<float> vertices(chunkQuads * 16);
+    double orphanFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+        time += 0.1f;
+        for (unsigned int first = 0; first < quadCount; first += chunkQuads)
+        {
+            writeQuads(vertices.data(), first);
+            orphanBuffer.SetData(vertices.data(), chunkSize);
+            renderer.Draw(orphanVA, ib, shader);
+        }
+    });
+
+    // Write the vertices straight into the mapped buffer
+    streamBuffer.ResetStats();
+    double streamFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+        time += 0.1f;
+        for (unsigned int first = 0; first < quadCount; first += chunkQuads)
+        {
+            writeQuads((float*)streamBuffer.Map(chunkSize, 4 * sizeof(float)), first);
+            unsigned int baseVertex = streamBuffer.Unmap(chunkSize, 4 * sizeof(float));
+
+            shader.Bind();
+            streamVA.Bind();
+            ib.Bind();
+            GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr, baseVertex));
+        }
+    });
+
+    const StreamBufferStats& stats = streamBuffer.GetStats();
+    std::cout << "quads: " << quadCount << " in chunks of " << chunkQuads << std::fixed << std::setprecision(3)
+        << ", orphaning: " << orphanFrameTime << " ms"
+        << ", " << (streamBuffer.IsPersistent() ? "persistent" : "unsynchronized") << " stream: " << streamFrameTime << " ms"
+        << " (" << stats.Wraps << " wraps, " << stats.Stalls << " stalls)" << std::endl;
+}
+
+static void BenchmarkDynamicBuffer()
+{
+    const unsigned int vertexCount = 1000000;
+    const unsigned int groupCount = 100;
+    const unsigned int groupSize = 10;
+
+    // A large mesh where a few groups of vertices animate, like the faces of a few characters in a crowd
+    std::vector<glm::vec4> vertices(vertexCount, glm::vec4(0.0f));
+    VertexBuffer buffer(vertexCount * sizeof(glm::vec4));
+    buffer.SetData(vertices.data(), vertexCount * sizeof(glm::vec4));
+
+    std::mt19937 random(1337);
+    std::uniform_int_distribution<unsigned int> start(0, vertexCount - groupSize);
+    std::vector<unsigned int> groups(groupCount);
+    for (auto& group : groups)
+        group = start(random);
+
+    float time = 0.0f;
+    auto animate = [&]()
+    {
+        time += 0.1f;
+        for (unsigned int group : groups)
+        {
+            for (unsigned int i = group; i < group + groupSize; i++)
+                vertices[i].x = std::sin(time + i);
+        }
+    };
+
+    double fullFrameTime = MeasureFrameTime(10, [&]()
+    {
+        animate();
+        buffer.SetData(vertices.data(), vertexCount * sizeof(glm::vec4));
+    });
+
+    unsigned int uploaded = 0;
+    double partialFrameTime = MeasureFrameTime(10, [&]()
+    {
+        animate();
+        for (unsigned int group : groups)
+            buffer.SetSubData(group * sizeof(glm::vec4), &vertices[group], groupSize * sizeof(glm::vec4));
+        uploaded = buffer.Upload();
+    });
+
+    std::cout << "vertices: " << vertexCount << ", animated: " << groupCount * groupSize << std::fixed << std::setprecision(3)
+        << ", SetData: " << vertexCount * sizeof(glm::vec4) << " bytes " << fullFrameTime << " ms"
+        << ", SetSubData: " << uploaded << " bytes " << partialFrameTime << " ms" << std::endl;
+}
+
+static void BenchmarkPerDrawConstants()
+{
+    const unsigned int drawCount = 10000;
+
+    float positions[] =
+    {
+        0.0f, 0.0f,
+        4.0f, 0.0f,
+        4.0f, 4.0f,
+        0.0f, 4.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexArray va;
+    VertexBuffer vb(positions, 4 * 2 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    va.AddBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+    Renderer renderer;
+
+    // The values of a draw in the std140 layout of the Draw block
+    struct DrawConstants
+    {
+        glm::mat4 Model;
+        glm::vec4 Color;
+    };
+
+    std::vector<DrawConstants> draws(drawCount);
+    std::vector<glm::vec2> positionsInWindow = CreatePositions(drawCount);
+    for (unsigned int i = 0; i < drawCount; i++)
+    {
+        draws[i].Model = glm::translate(glm::mat4(1.0f), glm::vec3(positionsInWindow[i], 0.0f));
+        draws[i].Color = { (i % 7) / 7.0f, (i % 5) / 5.0f, (i % 3) / 3.0f, 1.0f };
+    }
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+
+    // The old way: a glUniform call per value per draw
+    Shader uniformShader("res/shaders/Color.shader");
+    UniformHandle mvpUniform = uniformShader.GetUniform("u_MVP");
+    UniformHandle colorUniform = uniformShader.GetUniform("u_Color");
+    double uniformFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+        for (const auto& draw : draws)
+        {
+            glm::mat4 mvp = proj * draw.Model;
+            uniformShader.Bind();
+            uniformShader.SetUniformMat4f(mvpUniform, mvp);
+            uniformShader.SetUniform4f(colorUniform, draw.Color.r, draw.Color.g, draw.Color.b, draw.Color.a);
+            renderer.Draw(va, ib, uniformShader);
+        }
+    });
+
+    // Write every draw into the ring first, then bind a range per draw
+    Shader blockShader("res/shaders/ColorBlock.shader");
+    ASSERT(blockShader.GetUniformBlock("Draw") && blockShader.GetUniformBlock("Draw")->Size == sizeof(DrawConstants));
+
+    UniformBuffer camera("Camera", sizeof(glm::mat4));
+    camera.Set(0, proj);
+    camera.Upload();
+    camera.Bind();
+
+    UniformRingBuffer ring("Draw", drawCount * 256); // 256 is the largest offset alignment in practice
+    unsigned int frameSize = drawCount * ring.GetAlignedSize(sizeof(DrawConstants));
+    std::vector<unsigned int> handles(drawCount);
+
+    double ringFrameTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+
+        ring.Begin(frameSize);
+        for (unsigned int i = 0; i < drawCount; i++)
+            handles[i] = ring.Push(draws[i]);
+        ring.End();
+
+        for (unsigned int i = 0; i < drawCount; i++)
+        {
+            ring.Bind(handles[i], sizeof(DrawConstants));
+            renderer.Draw(va, ib, blockShader);
+        }
+    });
+
+    std::cout << "draws: " << drawCount << ", offset alignment: " << ring.GetAlignment() << std::fixed << std::setprecision(3)
+        << ", glUniform: " << uniformFrameTime << " ms"
+        << ", glBindBufferRange: " << ringFrameTime << " ms"
+        << " (" << ring.GetBuffer().GetStats().Stalls << " stalls)" << std::endl;
+}
+
+static void BenchmarkUniformLookup()
+{
+    const unsigned int callCount = 1000000;
+
+    Shader shader("res/shaders/Color.shader");
+    shader.Bind();
+
+    auto measure = [](const std::function<void()>& work)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        work();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    // The old lookup on its own: a string is built and hashed into a map for every call
+    std::unordered_map<std::string, int> locations = { { "u_MVP", 0 }, { "u_Color", 1 } };
+    volatile int sum = 0; // Keeps the lookups from being optimized away
+    double mapTime = measure([&]()
+    {
+        for (unsigned int i = 0; i < callCount; i++)
+            sum += locations[i & 1 ? "u_MVP" : "u_Color"];
+    });
+
+    // A string literal is hashed on every call, but nothing is allocated. The values never change,
+    // so the shadow copy turns all calls after the first into a compare
+    double literalTime = measure([&]()
+    {
+        for (unsigned int i = 0; i < callCount; i++)
+            shader.SetUniform4f("u_Color", 1.0f, 0.3f, 0.8f, 1.0f);
+    });
+
+    constexpr UniformName colorUniform("u_Color");
+    double hashedTime = measure([&]()
+    {
+        for (unsigned int i = 0; i < callCount; i++)
+            shader.SetUniform4f(colorUniform, 1.0f, 0.3f, 0.8f, 1.0f);
+    });
+    shader.Bind();
+    GLCall(glFinish());
+
+    std::cout << "calls: " << callCount << std::fixed << std::setprecision(2)
+        << ", string map lookups: " << mapTime << " ms"
+        << ", literal: " << literalTime << " ms"
+        << ", constexpr name: " << hashedTime << " ms"
+        << ", uploads: " << shader.GetUniformUploads() << std::endl;
+}
+
+static const char* s_ShaderPaths[] = {
+    "res/shaders/Basic.shader", "res/shaders/Batch.shader", "res/shaders/BatchArray.shader", "res/shaders/Blur.shader",
+    "res/shaders/Color.shader", "res/shaders/ColorBlock.shader", "res/shaders/Composite.shader", "res/shaders/Instanced.shader"
+};
+
+static void BenchmarkShaderCache()
+{
+    ShaderCache& cache = ShaderCache::Get();
+    if (!cache.IsSupported())
+        std::cout << "program binaries are not supported, every shader is compiled" << std::endl;
+
+    // The first round loads the binaries of a previous run or compiles and stores them, the second round always loads
+    for (unsigned int round = 0; round < 2; round++)
+    {
+        ShaderCacheStats before = cache.GetStats();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const char* path : s_ShaderPaths)
+            Shader shader(path);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        const ShaderCacheStats& stats = cache.GetStats();
+        std::cout << "round " << round + 1 << ": " << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double, std::milli>(end - start).count() << " ms"
+            << ", hits: " << stats.Hits - before.Hits << ", misses: " << stats.Misses - before.Misses
+            << ", compiling: " << stats.CompileTime - before.CompileTime << " ms"
+            << ", loading: " << stats.LoadTime - before.LoadTime << " ms"
+            << ", saved: " << stats.TimeSaved - before.TimeSaved << " ms" << std::endl;
+    }
+}
+
+static void BenchmarkAsyncCompile()
+{
+    Renderer renderer;
+    ShaderCompiler& compiler = ShaderCompiler::Get();
+
+    // Loading binaries would hide the compiler
+    ShaderCache::Get().SetEnabled(false);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const char* path : s_ShaderPaths)
+        Shader shader(path);
+    auto end = std::chrono::high_resolution_clock::now();
+    double blockingTime = std::chrono::duration<double, std::milli>(end - start).count();
+
+    // Queue every shader at once and keep rendering frames until all of them finished
+    std::vector<std::unique_ptr<Shader>> shaders;
+    start = std::chrono::high_resolution_clock::now();
+    for (const char* path : s_ShaderPaths)
+        shaders.push_back(std::make_unique<Shader>(path, true));
+    end = std::chrono::high_resolution_clock::now();
+    double queueTime = std::chrono::duration<double, std::milli>(end - start).count();
+
+    unsigned int frames = 0;
+    while (compiler.Update() > 0)
+    {
+        renderer.Clear();
+        GLCall(glFinish());
+        frames++;
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double readyTime = std::chrono::duration<double, std::milli>(end - start).count();
+
+    ShaderCache::Get().SetEnabled(true);
+
+    std::cout << "shaders: " << shaders.size() << (compiler.IsParallel() ? ", parallel compile" : ", no parallel compile")
+        << std::fixed << std::setprecision(2) << ", blocking: " << blockingTime << " ms"
+        << ", queueing: " << queueTime << " ms, all ready after: " << readyTime << " ms (" << frames << " frames rendered meanwhile)" << std::endl;
+}
+
+static void BenchmarkShaderVariants()
+{
+    float positions[] =
+    {
+        100.0f, 100.0f, 0.0f, 0.0f,
+        200.0f, 100.0f, 1.0f, 0.0f,
+        200.0f, 200.0f, 1.0f, 1.0f,
+        100.0f, 200.0f, 0.0f, 1.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexArray va;
+    VertexBuffer vb(positions, 4 * 4 * sizeof(float));
+    VertexBufferLayout layout;
+    layout.Push<float>(2);
+    layout.Push<float>(2);
+    va.AddBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+
+    Texture texture("res/textures/ChernoLogo.png");
+    texture.Bind();
+
+    Renderer renderer;
+    ShaderVariantCache variants;
+    glm::mat4 mvp = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    const unsigned int drawCount = 1000;
+
+    // Every frame asks for its variant, only the first frame compiles it
+    auto drawVariant = [&](bool flatColor)
+    {
+        Shader& shader = variants.Get("res/shaders/Basic.shader", flatColor ? std::vector<std::string>{ "FLAT_COLOR" } : std::vector<std::string>{});
+        shader.SetUniformMat4f("u_MVP", mvp);
+
+        // Each variant only keeps the uniform it reads, the compiler removes the other one
+        if (flatColor)
+            shader.SetUniform4f("u_Color", 0.8f, 0.3f, 0.8f, 1.0f);
+        else
+            shader.SetUniform1i("u_Texture", 0);
+
+        for (unsigned int i = 0; i < drawCount; i++)
+            renderer.Draw(va, ib, shader);
+    };
+
+    double texturedTime = MeasureFrameTime(10, [&]() { renderer.Clear(); drawVariant(false); });
+    double flatTime = MeasureFrameTime(10, [&]() { renderer.Clear(); drawVariant(true); });
+
+    // The order of the defines doesn't make a new variant
+    variants.Get("res/shaders/Basic.shader", { "FLAT_COLOR", "UNUSED" });
+    variants.Get("res/shaders/Basic.shader", { "UNUSED", "FLAT_COLOR" });
+
+    std::cout << "variants: " << variants.GetCount() << ", compiles: " << variants.GetCompileCount()
+        << std::fixed << std::setprecision(3) << ", textured (ms): " << texturedTime << ", flat color (ms): " << flatTime << std::endl;
+}
+
+static void BenchmarkShaderParser()
+{
+    const unsigned int copyCount = 20000;
+    const char* path = "parser_benchmark.shader";
+
+    // A large shader library, every shader file of the project many times over
+    {
+        std::ofstream library(path, std::ios::binary);
+        for (unsigned int i = 0; i < copyCount; i++)
+        {
+            const char* shaderPath = s_ShaderPaths[i % (sizeof(s_ShaderPaths) / sizeof(s_ShaderPaths[0]))];
+            std::ifstream shader(shaderPath, std::ios::binary);
+            library << shader.rdbuf() << '\n';
+        }
+    }
+
+    auto measure = [](const std::function<void()>& parse)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        parse();
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    // The old way: a line at a time through a stream, copying every line into a string stream
+    size_t streamSize = 0;
+    double streamTime = measure([&]()
+    {
+        std::ifstream stream(path);
+        std::string line;
+        std::stringstream ss[2];
+        int type = 0;
+        while (getline(stream, line))
+        {
+            if (line.find("#shader") != std::string::npos)
+                type = line.find("vertex") != std::string::npos ? 0 : 1;
+            else
+                ss[type] << line << '\n';
+        }
+        streamSize = ss[0].str().size() + ss[1].str().size();
+    });
+
+    size_t fileSize = 0;
+    double mappedTime = measure([&]()
+    {
+        MappedFile file(path);
+        fileSize = file.GetView().size();
+        ShaderProgramSource source = Shader::ParseShader(file.GetView());
+        ASSERT(!source.Get(ShaderStage::Fragment).empty());
+    });
+
+    std::remove(path);
+
+    double megabytes = fileSize / (1024.0 * 1024.0);
+    std::cout << "library: " << std::fixed << std::setprecision(2) << megabytes << " MB (" << streamSize / 1024 << " KB of stage text)"
+        << ", stream: " << streamTime << " ms (" << megabytes / streamTime * 1000.0 << " MB/s)"
+        << ", mapped: " << mappedTime << " ms (" << megabytes / mappedTime * 1000.0 << " MB/s)" << std::endl;
+}
+
+static void BenchmarkParticles()
+{
+    if (!GLEW_VERSION_4_3 && !GLEW_ARB_compute_shader)
+    {
+        std::cout << "compute shaders are not supported, they need OpenGL 4.3 or ARB_compute_shader" << std::endl;
+        return;
+    }
+
+    const unsigned int particleCount = 1000000;
+    const float deltaTime = 1.0f / 60.0f;
+    const glm::vec2 attractor(480.0f, 270.0f);
+
+    // A particle is a position and a velocity, which is also its std430 layout
+    std::vector<glm::vec4> particles(particleCount);
+    std::vector<glm::vec2> positions = CreatePositions(particleCount);
+    for (unsigned int i = 0; i < particleCount; i++)
+        particles[i] = { positions[i], 0.0f, 0.0f };
+
+    // A quad of a pixel that every particle moves to its position
+    float corners[] =
+    {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f,
+    };
+    unsigned int indices[] = { 0, 1, 2, 2, 3, 0 };
+
+    VertexBuffer cornerBuffer(corners, 4 * 2 * sizeof(float));
+    VertexBufferLayout cornerLayout;
+    cornerLayout.Push<float>(2);
+
+    VertexBufferLayout particleLayout;
+    particleLayout.Push<float>(4);
+    particleLayout.SetDivisor(1);
+
+    IndexBuffer ib(indices, 6);
+    Shader drawShader("res/shaders/Particle.shader");
+    Renderer renderer;
+
+    glm::mat4 proj = glm::ortho(0.0f, 960.0f, 0.0f, 540.0f, -1.0f, 1.0f);
+    drawShader.SetUniformMat4f("u_ViewProjection", proj);
+
+    // The CPU moves every particle and uploads all of them each frame
+    VertexArray cpuVa;
+    cpuVa.AddBuffer(cornerBuffer, cornerLayout);
+    VertexBuffer cpuParticles(particleCount * sizeof(glm::vec4)); // Dynamic, it's replaced every frame
+    cpuParticles.SetData(particles.data(), particleCount * sizeof(glm::vec4));
+    cpuVa.AddBuffer(cpuParticles, particleLayout);
+
+    std::vector<glm::vec4> cpuState = particles;
+    double cpuTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+
+        for (glm::vec4& particle : cpuState)
+        {
+            glm::vec2 position(particle.x, particle.y), velocity(particle.z, particle.w);
+            velocity += glm::normalize(attractor - position + glm::vec2(0.001f)) * 200.0f * deltaTime;
+            velocity *= 0.995f;
+            position += velocity * deltaTime;
+
+            if (position.x < 0.0f || position.x > 960.0f)
+                velocity.x = -velocity.x;
+            if (position.y < 0.0f || position.y > 540.0f)
+                velocity.y = -velocity.y;
+            position = glm::clamp(position, glm::vec2(0.0f), glm::vec2(960.0f, 540.0f));
+
+            particle = { position, velocity };
+        }
+        cpuParticles.SetData(cpuState.data(), particleCount * sizeof(glm::vec4));
+
+        renderer.DrawInstanced(cpuVa, ib, drawShader, particleCount);
+    });
+
+    // A compute shader moves the particles in a storage buffer that is drawn from directly
+    Shader updateShader("res/shaders/ParticleUpdate.shader");
+    ShaderStorageBuffer gpuParticles("Particles", particleCount * sizeof(glm::vec4), particles.data());
+    ASSERT(updateShader.GetStorageBlock("Particles"));
+
+    VertexArray gpuVa;
+    gpuVa.AddBuffer(cornerBuffer, cornerLayout);
+    gpuVa.AddBuffer(gpuParticles, particleLayout);
+
+    updateShader.SetUniform1f("u_DeltaTime", deltaTime);
+    updateShader.SetUniform2f("u_Attractor", attractor.x, attractor.y);
+    updateShader.SetUniform1i("u_Count", (int)particleCount);
+    unsigned int groupSize = updateShader.GetWorkGroupSize().x;
+
+    double gpuTime = MeasureFrameTime(10, [&]()
+    {
+        renderer.Clear();
+
+        gpuParticles.Bind();
+        renderer.Dispatch(updateShader, (particleCount + groupSize - 1) / groupSize);
+
+        renderer.DrawInstanced(gpuVa, ib, drawShader, particleCount);
+    });
+
+    std::cout << "particles: " << particleCount << ", cpu update + upload: " << std::fixed << std::setprecision(3) << cpuTime
+        << " ms, compute shader: " << gpuTime << " ms" << std::endl;
+}
+
+static void BenchmarkTextureLoading()
+{
+    const unsigned int textureCount = 64;
+    const char* path = "res/textures/ChernoLogo.png";
+    Renderer renderer;
+
+    // Decoding on the render thread stalls it for every texture
+    auto start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<std::unique_ptr<Texture>> textures;
+        for (unsigned int i = 0; i < textureCount; i++)
+            textures.push_back(std::make_unique<Texture>(path));
+        GLCall(glFinish());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double syncTime = std::chrono::duration<double, std::milli>(end - start).count();
+
+    // The workers decode while the render thread keeps drawing frames and only uploads
+    TextureLoader& loader = TextureLoader::Get();
+    unsigned int frames = 0;
+    double longestFrame = 0.0;
+
+    start = std::chrono::high_resolution_clock::now();
+    {
+        std::vector<std::unique_ptr<Texture>> textures;
+        for (unsigned int i = 0; i < textureCount; i++)
+            textures.push_back(std::make_unique<Texture>(path, true));
+
+        unsigned int pending = loader.GetPendingCount();
+        while (pending > 0)
+        {
+            auto frameStart = std::chrono::high_resolution_clock::now();
+            renderer.Clear();
+            pending = loader.Update();
+            GLCall(glFinish());
+            auto frameEnd = std::chrono::high_resolution_clock::now();
+
+            longestFrame = std::max(longestFrame, std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+            frames++;
+        }
+
+        ASSERT(textures.back()->IsReady());
+    }
+    end = std::chrono::high_resolution_clock::now();
+    double asyncTime = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "textures: " << textureCount << ", blocking: " << std::fixed << std::setprecision(3) << syncTime
+        << " ms, async: " << asyncTime << " ms over " << frames << " frames (longest frame " << longestFrame << " ms)" << std::endl;
+}
+
+struct BenchmarkEntry
+{
+    const char* Name;
+    void(*Function)();
+};
+
+static const BenchmarkEntry s_Benchmarks[] =
+{
+    { "batch", BenchmarkBatchRenderer },
+    { "queue", BenchmarkRenderQueue },
+    { "instancing", BenchmarkInstancing },
+    { "indirect", BenchmarkMultiDrawIndirect },
+    { "recording", BenchmarkParallelRecording },
+    { "framegraph", BenchmarkFrameGraph },
+    { "texturearray", BenchmarkTextureArray },
+    { "culling", BenchmarkCulling },
+    { "spatial", BenchmarkSpatialIndex },
+    { "streaming", BenchmarkStreaming },
+    { "dynamicbuffer", BenchmarkDynamicBuffer },
+    { "perdraw", BenchmarkPerDrawConstants },
+    { "uniforms", BenchmarkUniformLookup },
+    { "shadercache", BenchmarkShaderCache },
+    { "asynccompile", BenchmarkAsyncCompile },
+    { "variants", BenchmarkShaderVariants },
+    { "parser", BenchmarkShaderParser },
+    { "particles", BenchmarkParticles },
+    { "textureload", BenchmarkTextureLoading },
+};
+
+bool RunBenchmarks(const std::string& name)
+{
+    bool found = false;
+
+    for (const auto& benchmark : s_Benchmarks)
+    {
+        if (name != "all" && name != benchmark.Name)
+            continue;
+
+        std::cout << "[Benchmark] " << benchmark.Name << std::endl;
+        GLStateCache::Get().ResetStats();
+        benchmark.Function();
+
+        const GLStateCacheStats& cache = GLStateCache::Get().GetStats();
+        std::cout << "GL binds skipped by the state cache: " << cache.Hits << " of " << (cache.Hits + cache.Misses) << std::endl;
+        found = true;
+    }
+
+    return found;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <string>
+
+/**
+Run one of the benchmarks on the current OpenGL context and print the results to the console.
+For headless numbers run with LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe.
+
+@param name The name of the benchmark or "all" to run every benchmark
+@return Whether a benchmark with the given name exists
+*/
+bool RunBenchmarks(const std::string& name);
\ No newline at end of file
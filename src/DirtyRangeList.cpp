@@ -0,0 +1,50 @@
+#include "DirtyRangeList.h"
+
+#include <algorithm>
+
+DirtyRangeList::DirtyRangeList(unsigned int mergeDistance)
+    : m_MergeDistance(mergeDistance)
+{
+}
+
+void DirtyRangeList::Add(unsigned int offset, unsigned int size)
+{
+    if (size == 0)
+        return;
+
+    // Extend the last range when writes continue where the previous one ended, the common case
+    if (!m_Ranges.empty())
+    {
+        DirtyRange& last = m_Ranges.back();
+        if (offset >= last.Offset && offset <= last.Offset + last.Size + m_MergeDistance)
+        {
+            last.Size = std::max(last.Size, offset + size - last.Offset);
+            return;
+        }
+    }
+
+    m_Ranges.push_back({ offset, size });
+}
+
+const std::vector<DirtyRange>& DirtyRangeList::Merge()
+{
+    if (m_Ranges.size() < 2)
+        return m_Ranges;
+
+    std::sort(m_Ranges.begin(), m_Ranges.end(), [](const DirtyRange& a, const DirtyRange& b) { return a.Offset < b.Offset; });
+
+    unsigned int merged = 0;
+    for (unsigned int i = 1; i < m_Ranges.size(); i++)
+    {
+        DirtyRange& current = m_Ranges[merged];
+        const DirtyRange& next = m_Ranges[i];
+
+        if (next.Offset <= current.Offset + current.Size + m_MergeDistance)
+            current.Size = std::max(current.Size, next.Offset + next.Size - current.Offset);
+        else
+            m_Ranges[++merged] = next;
+    }
+
+    m_Ranges.resize(merged + 1);
+    return m_Ranges;
+}
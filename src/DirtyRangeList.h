@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+/**
+A range of bytes in a buffer that was changed on the CPU and still has to be uploaded.
+*/
+struct DirtyRange
+{
+    unsigned int Offset;
+    unsigned int Size;
+};
+
+/**
+Collects the changed ranges of a buffer between two uploads, overlapping and nearby ranges are merged
+so a few scattered changes don't turn into hundreds of tiny uploads.
+*/
+class DirtyRangeList
+{
+private:
+    std::vector<DirtyRange> m_Ranges;
+    unsigned int m_MergeDistance;
+public:
+    /**
+        @param mergeDistance Ranges with fewer bytes than this between them are uploaded as one
+    */
+    DirtyRangeList(unsigned int mergeDistance = 256);
+
+    void Add(unsigned int offset, unsigned int size);
+
+    /**
+        Sort and merge the ranges.
+
+        @return The ranges to upload, valid until the next Add or Clear
+    */
+    const std::vector<DirtyRange>& Merge();
+
+    inline void Clear() { m_Ranges.clear(); }
+    inline bool IsEmpty() const { return m_Ranges.empty(); }
+};
\ No newline at end of file
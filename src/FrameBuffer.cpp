@@ -0,0 +1,32 @@
+#include "FrameBuffer.h"
+#include "Renderer.h"
+
+FrameBuffer::FrameBuffer(const Texture& colorAttachment)
+    : m_RendererID(0), m_Width(colorAttachment.GetWidth()), m_Height(colorAttachment.GetHeight())
+{
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLStateCache::Get().BindFrameBuffer(m_RendererID);
+    GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorAttachment.GetRendererID(), 0));
+
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    ASSERT(status == GL_FRAMEBUFFER_COMPLETE);
+
+    GLStateCache::Get().BindFrameBuffer(0);
+}
+
+FrameBuffer::~FrameBuffer()
+{
+    GLStateCache::Get().OnDeleteFrameBuffer(m_RendererID);
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+}
+
+void FrameBuffer::Bind() const
+{
+    GLStateCache::Get().BindFrameBuffer(m_RendererID);
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void FrameBuffer::Unbind() const
+{
+    GLStateCache::Get().BindFrameBuffer(0);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Texture.h"
+
+/**
+A framebuffer that renders into a single color texture.
+*/
+class FrameBuffer
+{
+private:
+    unsigned int m_RendererID;
+    int m_Width, m_Height;
+public:
+    /**
+        Create a framebuffer with the texture as its color attachment.
+
+        @param colorAttachment The texture to render into, it has to outlive the framebuffer
+    */
+    FrameBuffer(const Texture& colorAttachment);
+    ~FrameBuffer();
+
+    /**
+        Bind the framebuffer and set the viewport to the size of its attachment.
+    */
+    void Bind() const;
+
+    /**
+        Bind the default framebuffer of the window again.
+    */
+    void Unbind() const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+};
\ No newline at end of file
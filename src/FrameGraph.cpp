@@ -0,0 +1,286 @@
+#include "FrameGraph.h"
+#include "Renderer.h"
+
+#include <algorithm>
+
+FrameGraphPass::FrameGraphPass(const std::string& name, const std::function<void(const FrameGraph&)>& execute)
+    : m_Name(name), m_Execute(execute), m_RefCount(0)
+{
+}
+
+void FrameGraphPass::Read(FrameGraphResource resource)
+{
+    m_Reads.push_back(resource);
+}
+
+void FrameGraphPass::Write(FrameGraphResource resource)
+{
+    ASSERT(m_Writes.empty());
+    m_Writes.push_back(resource);
+}
+
+FrameGraph::FrameGraph()
+    : m_Compiled(false)
+{
+}
+
+FrameGraphResource FrameGraph::CreateTexture(const std::string& name, const FrameGraphTextureDesc& desc)
+{
+    m_Resources.emplace_back(new Resource{ name, desc, false, nullptr, nullptr, 0, -1, -1, -1 });
+    return (FrameGraphResource)(m_Resources.size() - 1);
+}
+
+FrameGraphResource FrameGraph::ImportTexture(const std::string& name, const Texture& texture)
+{
+    FrameGraphTextureDesc desc = { texture.GetWidth(), texture.GetHeight(), GL_RGBA8 };
+    m_Resources.emplace_back(new Resource{ name, desc, true, &texture, std::unique_ptr<FrameBuffer>(new FrameBuffer(texture)), 0, -1, -1, -1 });
+    return (FrameGraphResource)(m_Resources.size() - 1);
+}
+
+FrameGraphResource FrameGraph::ImportBackbuffer(int width, int height)
+{
+    FrameGraphTextureDesc desc = { width, height, GL_RGBA8 };
+    m_Resources.emplace_back(new Resource{ "Backbuffer", desc, true, nullptr, nullptr, 0, -1, -1, -1 });
+    return (FrameGraphResource)(m_Resources.size() - 1);
+}
+
+FrameGraphPass& FrameGraph::AddPass(const std::string& name, const std::function<void(const FrameGraph&)>& execute)
+{
+    m_Passes.emplace_back(new FrameGraphPass(name, execute));
+    m_Compiled = false;
+    return *m_Passes.back();
+}
+
+void FrameGraph::Compile()
+{
+    m_Stats = FrameGraphStats();
+
+    CullPasses();
+    SchedulePasses();
+    AssignPhysicalTextures();
+
+    m_Compiled = true;
+}
+
+void FrameGraph::Execute()
+{
+    if (!m_Compiled)
+        Compile();
+
+    for (unsigned int position = 0; position < m_Order.size(); position++)
+    {
+        const FrameGraphPass& pass = *m_Passes[m_Order[position]];
+
+        for (FrameGraphResource handle : pass.m_Writes)
+        {
+            const Resource& resource = *m_Resources[handle];
+
+            if (!resource.Imported)
+            {
+                m_Pool[resource.Physical]->Target->Bind();
+
+                // The texture may hold the results of a resource it aliases, so clear it once before it's first written
+                if (resource.FirstUse == (int)position)
+                {
+                    GLCall(glClear(GL_COLOR_BUFFER_BIT));
+                }
+            }
+            else if (resource.ImportedFrameBuffer)
+            {
+                resource.ImportedFrameBuffer->Bind();
+            }
+            else
+            {
+                GLStateCache::Get().BindFrameBuffer(0);
+                GLCall(glViewport(0, 0, resource.Desc.Width, resource.Desc.Height));
+            }
+        }
+
+        pass.m_Execute(*this);
+    }
+
+    GLStateCache::Get().BindFrameBuffer(0);
+}
+
+void FrameGraph::Reset()
+{
+    m_Passes.clear();
+    m_Resources.clear();
+    m_Order.clear();
+    m_Compiled = false;
+}
+
+const Texture& FrameGraph::GetTexture(FrameGraphResource resource) const
+{
+    const Resource& entry = *m_Resources[resource];
+
+    if (entry.Imported)
+    {
+        ASSERT(entry.ImportedTexture); // The backbuffer can't be sampled
+        return *entry.ImportedTexture;
+    }
+
+    ASSERT(entry.Physical >= 0);
+    return *m_Pool[entry.Physical]->Tex;
+}
+
+void FrameGraph::CullPasses()
+{
+    for (auto& resource : m_Resources)
+    {
+        resource->RefCount = 0;
+        resource->FirstUse = -1;
+        resource->LastUse = -1;
+        resource->Physical = -1;
+    }
+
+    // Count the writes of every pass and the reads of every resource
+    for (auto& pass : m_Passes)
+    {
+        pass->m_RefCount = (unsigned int)pass->m_Writes.size();
+        for (FrameGraphResource resource : pass->m_Reads)
+            m_Resources[resource]->RefCount++;
+    }
+
+    // Start at the transient resources nobody reads, imported resources are the outputs of the frame
+    std::vector<FrameGraphResource> unused;
+    for (unsigned int i = 0; i < m_Resources.size(); i++)
+    {
+        if (!m_Resources[i]->Imported && m_Resources[i]->RefCount == 0)
+            unused.push_back(i);
+    }
+
+    // A pass whose writes are all unused is culled, which may leave the resources it reads unused as well
+    while (!unused.empty())
+    {
+        FrameGraphResource resource = unused.back();
+        unused.pop_back();
+
+        for (auto& pass : m_Passes)
+        {
+            if (std::find(pass->m_Writes.begin(), pass->m_Writes.end(), resource) == pass->m_Writes.end())
+                continue;
+
+            if (--pass->m_RefCount > 0)
+                continue;
+
+            for (FrameGraphResource read : pass->m_Reads)
+            {
+                Resource& readResource = *m_Resources[read];
+                if (--readResource.RefCount == 0 && !readResource.Imported)
+                    unused.push_back(read);
+            }
+        }
+    }
+}
+
+void FrameGraph::SchedulePasses()
+{
+    m_Order.clear();
+
+    // A pass can only read what an earlier declared pass wrote, so the declared order of the passes
+    // that survived culling already satisfies every dependency. Passes without writes are culled as well.
+    for (unsigned int i = 0; i < m_Passes.size(); i++)
+    {
+        if (m_Passes[i]->m_RefCount > 0)
+            m_Order.push_back(i);
+        else
+            m_Stats.PassesCulled++;
+    }
+
+    m_Stats.PassesExecuted = (unsigned int)m_Order.size();
+}
+
+void FrameGraph::AssignPhysicalTextures()
+{
+    // The lifetime of a resource is the range of executed passes that use it
+    for (unsigned int position = 0; position < m_Order.size(); position++)
+    {
+        const FrameGraphPass& pass = *m_Passes[m_Order[position]];
+
+        for (FrameGraphResource handle : pass.m_Reads)
+        {
+            Resource& resource = *m_Resources[handle];
+            ASSERT(resource.Imported || resource.FirstUse >= 0); // A transient texture has to be written before it's read
+            resource.LastUse = position;
+        }
+
+        for (FrameGraphResource handle : pass.m_Writes)
+        {
+            Resource& resource = *m_Resources[handle];
+            if (resource.FirstUse < 0)
+                resource.FirstUse = position;
+            resource.LastUse = position;
+        }
+    }
+
+    for (auto& physical : m_Pool)
+        physical->InUse = false;
+
+    for (unsigned int position = 0; position < m_Order.size(); position++)
+    {
+        // Acquire everything starting here before releasing what ends here, so a pass never reads and writes the same texture
+        for (auto& resource : m_Resources)
+        {
+            if (!resource->Imported && resource->FirstUse == (int)position)
+            {
+                resource->Physical = AcquirePhysicalTexture(resource->Desc);
+                m_Stats.TransientTextures++;
+                m_Stats.TransientBytes += resource->Desc.Width * resource->Desc.Height * GetBytesPerPixel(resource->Desc.Format);
+            }
+        }
+
+        for (auto& resource : m_Resources)
+        {
+            if (!resource->Imported && resource->LastUse == (int)position)
+                m_Pool[resource->Physical]->InUse = false;
+        }
+    }
+}
+
+int FrameGraph::AcquirePhysicalTexture(const FrameGraphTextureDesc& desc)
+{
+    int index = -1;
+
+    for (unsigned int i = 0; i < m_Pool.size(); i++)
+    {
+        if (!m_Pool[i]->InUse && m_Pool[i]->Desc == desc)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    if (index < 0)
+    {
+        PhysicalTexture* physical = new PhysicalTexture{ desc, std::unique_ptr<Texture>(new Texture(desc.Width, desc.Height, desc.Format)), nullptr, false };
+        physical->Target.reset(new FrameBuffer(*physical->Tex));
+        m_Pool.emplace_back(physical);
+        index = (int)m_Pool.size() - 1;
+    }
+
+    // Count every physical texture once per frame, the first time it's handed out
+    bool firstUse = std::none_of(m_Resources.begin(), m_Resources.end(), [index](const std::unique_ptr<Resource>& resource) { return resource->Physical == index; });
+    if (firstUse)
+    {
+        m_Stats.PhysicalTextures++;
+        m_Stats.PhysicalBytes += desc.Width * desc.Height * GetBytesPerPixel(desc.Format);
+    }
+
+    m_Pool[index]->InUse = true;
+    return index;
+}
+
+unsigned int FrameGraph::GetBytesPerPixel(unsigned int format)
+{
+    switch (format)
+    {
+        case GL_RGBA8:      return 4;
+        case GL_RGBA16F:    return 8;
+        case GL_RGBA32F:    return 16;
+        case GL_R8:         return 1;
+        case GL_RG16F:      return 4;
+    }
+
+    return 4;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+#include "FrameBuffer.h"
+
+/**
+A handle to a texture in the frame graph.
+*/
+typedef unsigned int FrameGraphResource;
+
+/**
+The description of a transient texture, textures with the same description can share memory.
+*/
+struct FrameGraphTextureDesc
+{
+    int Width;
+    int Height;
+    unsigned int Format; // The internal format, like GL_RGBA8
+
+    inline bool operator==(const FrameGraphTextureDesc& other) const { return Width == other.Width && Height == other.Height && Format == other.Format; }
+};
+
+/**
+Statistics about the last compile of the graph.
+*/
+struct FrameGraphStats
+{
+    unsigned int PassesExecuted = 0;
+    unsigned int PassesCulled = 0;
+    unsigned int TransientTextures = 0; // Transient textures used by the executed passes
+    unsigned int PhysicalTextures = 0; // The textures they were aliased onto
+    unsigned int TransientBytes = 0; // The memory the transient textures would take without aliasing
+    unsigned int PhysicalBytes = 0; // The memory they take with aliasing
+};
+
+class FrameGraph;
+
+/**
+A pass that declares the textures it reads and writes. Declare passes in the order their results are produced,
+a pass can only read textures that an earlier pass wrote.
+*/
+class FrameGraphPass
+{
+private:
+    friend class FrameGraph;
+
+    std::string m_Name;
+    std::function<void(const FrameGraph&)> m_Execute;
+    std::vector<FrameGraphResource> m_Reads;
+    std::vector<FrameGraphResource> m_Writes;
+    unsigned int m_RefCount;
+public:
+    FrameGraphPass(const std::string& name, const std::function<void(const FrameGraph&)>& execute);
+
+    /**
+        Declare a texture the pass samples from.
+    */
+    void Read(FrameGraphResource resource);
+
+    /**
+        Declare the texture the pass renders into, a pass renders into a single texture at most.
+        A transient texture is cleared before the first pass that writes it.
+    */
+    void Write(FrameGraphResource resource);
+
+    inline const std::string& GetName() const { return m_Name; }
+};
+
+/**
+Schedules the passes of a frame. Passes that don't contribute to an imported texture or the backbuffer are culled,
+and transient textures whose lifetimes don't overlap share the same texture.
+*/
+class FrameGraph
+{
+private:
+    struct Resource
+    {
+        std::string Name;
+        FrameGraphTextureDesc Desc;
+        bool Imported;
+        const Texture* ImportedTexture; // nullptr for the backbuffer
+        std::unique_ptr<FrameBuffer> ImportedFrameBuffer;
+        unsigned int RefCount;
+        int FirstUse;
+        int LastUse;
+        int Physical;
+    };
+
+    struct PhysicalTexture
+    {
+        FrameGraphTextureDesc Desc;
+        std::unique_ptr<Texture> Tex;
+        std::unique_ptr<FrameBuffer> Target;
+        bool InUse;
+    };
+
+    std::vector<std::unique_ptr<FrameGraphPass>> m_Passes;
+    std::vector<std::unique_ptr<Resource>> m_Resources;
+    std::vector<unsigned int> m_Order;
+    std::vector<std::unique_ptr<PhysicalTexture>> m_Pool; // Kept between frames, so textures are only created once
+    FrameGraphStats m_Stats;
+    bool m_Compiled;
+public:
+    FrameGraph();
+
+    /**
+        Declare a texture that only lives during the frame.
+
+        @param name The name of the texture for debugging
+        @param desc The size and format of the texture
+        @return The handle of the texture
+    */
+    FrameGraphResource CreateTexture(const std::string& name, const FrameGraphTextureDesc& desc);
+
+    /**
+        Declare a texture that lives outside of the graph, passes writing to it are never culled.
+    */
+    FrameGraphResource ImportTexture(const std::string& name, const Texture& texture);
+
+    /**
+        Declare the backbuffer of the window, passes writing to it are never culled.
+    */
+    FrameGraphResource ImportBackbuffer(int width, int height);
+
+    /**
+        Add a pass, declare what it reads and writes on the returned pass.
+
+        @param name The name of the pass for debugging
+        @param execute Renders the pass, the texture it writes is bound as render target
+        @return The pass
+    */
+    FrameGraphPass& AddPass(const std::string& name, const std::function<void(const FrameGraph&)>& execute);
+
+    /**
+        Cull unused passes, schedule the others and assign textures to the transient resources.
+    */
+    void Compile();
+
+    /**
+        Execute the compiled passes in order.
+    */
+    void Execute();
+
+    /**
+        Remove all passes and resources to build the next frame, the textures are kept for reuse.
+    */
+    void Reset();
+
+    /**
+        Return the texture behind a resource, only valid while the graph executes.
+    */
+    const Texture& GetTexture(FrameGraphResource resource) const;
+
+    inline const FrameGraphStats& GetStats() const { return m_Stats; }
+private:
+    void CullPasses();
+    void SchedulePasses();
+    void AssignPhysicalTextures();
+    int AcquirePhysicalTexture(const FrameGraphTextureDesc& desc);
+
+    static unsigned int GetBytesPerPixel(unsigned int format);
+};
\ No newline at end of file
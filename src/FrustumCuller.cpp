@@ -0,0 +1,158 @@
+#include "FrustumCuller.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <xmmintrin.h> // SSE is part of every x64 target
+#endif
+
+Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+{
+    // Gribb-Hartmann: the planes are sums and differences of the rows of the matrix, glm stores columns
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+    // The planes are not normalized, the culling test only compares signs
+    Frustum frustum;
+    frustum.Planes[0] = rows[3] + rows[0];
+    frustum.Planes[1] = rows[3] - rows[0];
+    frustum.Planes[2] = rows[3] + rows[1];
+    frustum.Planes[3] = rows[3] - rows[1];
+    frustum.Planes[4] = rows[3] + rows[2];
+    frustum.Planes[5] = rows[3] - rows[2];
+    return frustum;
+}
+
+void AABBList::Add(const glm::vec3& min, const glm::vec3& max)
+{
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 extent = (max - min) * 0.5f;
+
+    CenterX.push_back(center.x);
+    CenterY.push_back(center.y);
+    CenterZ.push_back(center.z);
+    ExtentX.push_back(extent.x);
+    ExtentY.push_back(extent.y);
+    ExtentZ.push_back(extent.z);
+}
+
+void AABBList::AddQuad(const glm::vec2& position, const glm::vec2& size)
+{
+    Add(glm::vec3(position, 0.0f), glm::vec3(position + size, 0.0f));
+}
+
+void AABBList::Clear()
+{
+    CenterX.clear();
+    CenterY.clear();
+    CenterZ.clear();
+    ExtentX.clear();
+    ExtentY.clear();
+    ExtentZ.clear();
+}
+
+void FrustumCuller::Cull(const Frustum& frustum, const AABBList& boxes, std::vector<unsigned int>& visible, ThreadPool* pool)
+{
+    visible.clear();
+
+    if (!pool)
+    {
+        CullRange(frustum, boxes, 0, boxes.GetCount(), visible);
+        return;
+    }
+
+    // Every worker fills its own list, appending them in chunk order keeps the indices sorted
+    std::vector<std::vector<unsigned int>> chunks(pool->GetThreadCount());
+    pool->ParallelFor(boxes.GetCount(), [&](unsigned int begin, unsigned int end, unsigned int chunk)
+    {
+        chunks[chunk].reserve(end - begin);
+        CullRange(frustum, boxes, begin, end, chunks[chunk]);
+    });
+
+    for (const auto& chunk : chunks)
+        visible.insert(visible.end(), chunk.begin(), chunk.end());
+}
+
+void FrustumCuller::CullRange(const Frustum& frustum, const AABBList& boxes, unsigned int begin, unsigned int end, std::vector<unsigned int>& visible)
+{
+    // A box is outside a plane when even its corner furthest along the normal is behind it:
+    // dot(normal, center) + w + dot(abs(normal), extent) < 0
+    glm::vec4 absPlanes[6];
+    for (int p = 0; p < 6; p++)
+        absPlanes[p] = glm::vec4(std::abs(frustum.Planes[p].x), std::abs(frustum.Planes[p].y), std::abs(frustum.Planes[p].z), 0.0f);
+
+    unsigned int i = begin;
+
+#if defined(__AVX__)
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(&boxes.CenterX[i]);
+        __m256 cy = _mm256_loadu_ps(&boxes.CenterY[i]);
+        __m256 cz = _mm256_loadu_ps(&boxes.CenterZ[i]);
+        __m256 ex = _mm256_loadu_ps(&boxes.ExtentX[i]);
+        __m256 ey = _mm256_loadu_ps(&boxes.ExtentY[i]);
+        __m256 ez = _mm256_loadu_ps(&boxes.ExtentZ[i]);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (int p = 0; p < 6; p++)
+        {
+            const glm::vec4& plane = frustum.Planes[p];
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.x)), _mm256_mul_ps(cy, _mm256_set1_ps(plane.y))),
+                _mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(absPlanes[p].x)), _mm256_mul_ps(ey, _mm256_set1_ps(absPlanes[p].y))),
+                _mm256_mul_ps(ez, _mm256_set1_ps(absPlanes[p].z)));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        for (int mask = _mm256_movemask_ps(inside), bit = 0; mask; mask >>= 1, bit++)
+        {
+            if (mask & 1)
+                visible.push_back(i + bit);
+        }
+    }
+#endif
+
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(&boxes.CenterX[i]);
+        __m128 cy = _mm_loadu_ps(&boxes.CenterY[i]);
+        __m128 cz = _mm_loadu_ps(&boxes.CenterZ[i]);
+        __m128 ex = _mm_loadu_ps(&boxes.ExtentX[i]);
+        __m128 ey = _mm_loadu_ps(&boxes.ExtentY[i]);
+        __m128 ez = _mm_loadu_ps(&boxes.ExtentZ[i]);
+        __m128 inside = _mm_cmpeq_ps(cx, cx); // All bits set, NaN centers are culled
+
+        for (int p = 0; p < 6; p++)
+        {
+            const glm::vec4& plane = frustum.Planes[p];
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(absPlanes[p].x)), _mm_mul_ps(ey, _mm_set1_ps(absPlanes[p].y))),
+                _mm_mul_ps(ez, _mm_set1_ps(absPlanes[p].z)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        for (int mask = _mm_movemask_ps(inside), bit = 0; mask; mask >>= 1, bit++)
+        {
+            if (mask & 1)
+                visible.push_back(i + bit);
+        }
+    }
+
+    // The boxes that don't fill a register
+    for (; i < end; i++)
+    {
+        bool inside = true;
+        glm::vec3 center(boxes.CenterX[i], boxes.CenterY[i], boxes.CenterZ[i]);
+        glm::vec3 extent(boxes.ExtentX[i], boxes.ExtentY[i], boxes.ExtentZ[i]);
+
+        for (int p = 0; p < 6 && inside; p++)
+            inside = glm::dot(glm::vec3(frustum.Planes[p]), center) + frustum.Planes[p].w + glm::dot(glm::vec3(absPlanes[p]), extent) >= 0.0f;
+
+        if (inside)
+            visible.push_back(i);
+    }
+}
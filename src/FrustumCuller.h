@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "ThreadPool.h"
+
+#include "glm/glm.hpp"
+
+/**
+The six planes of a view frustum, a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+*/
+struct Frustum
+{
+    glm::vec4 Planes[6]; // left, right, bottom, top, near, far
+
+    /**
+        Extract the planes from a view projection matrix, like the glm::ortho projection of the application.
+    */
+    static Frustum FromMatrix(const glm::mat4& viewProjection);
+};
+
+/**
+Axis aligned bounding boxes stored as a structure of arrays, so the culler loads 4 or 8 boxes per instruction.
+*/
+struct AABBList
+{
+    std::vector<float> CenterX, CenterY, CenterZ;
+    std::vector<float> ExtentX, ExtentY, ExtentZ; // Half the size on every axis
+
+    void Add(const glm::vec3& min, const glm::vec3& max);
+
+    /**
+        Add the bounds of a 2D quad, like the ones given to BatchRenderer::DrawQuad.
+    */
+    void AddQuad(const glm::vec2& position, const glm::vec2& size);
+
+    void Clear();
+
+    inline unsigned int GetCount() const { return (unsigned int)CenterX.size(); }
+};
+
+class FrustumCuller
+{
+public:
+    /**
+        Test all boxes against the frustum, 8 at a time with AVX or 4 at a time with SSE.
+
+        @param frustum The frustum to test against
+        @param boxes The boxes to test
+        @param visible Filled with the indices of the boxes that intersect the frustum, in ascending order
+        @param pool The workers to spread the boxes over, or nullptr to cull on the calling thread
+    */
+    static void Cull(const Frustum& frustum, const AABBList& boxes, std::vector<unsigned int>& visible, ThreadPool* pool = nullptr);
+private:
+
+    /**
+        Cull a range of boxes and append the visible indices.
+    */
+    static void CullRange(const Frustum& frustum, const AABBList& boxes, unsigned int begin, unsigned int end, std::vector<unsigned int>& visible);
+};
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "GLStateCache.h"
+#include "Renderer.h"
+
+GLStateCache::GLStateCache()
+{
+    Invalidate();
+}
+
+GLStateCache& GLStateCache::Get()
+{
+    static GLStateCache cache;
+    return cache;
+}
+
+void GLStateCache::UseProgram(unsigned int program)
+{
+    if (m_Program == program)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    GLCall(glUseProgram(program));
+    m_Program = program;
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindFrameBuffer(unsigned int frameBuffer)
+{
+    if (m_FrameBuffer == frameBuffer)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer));
+    m_FrameBuffer = frameBuffer;
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindVertexArray(unsigned int vertexArray)
+{
+    if (m_VertexArray == vertexArray)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    GLCall(glBindVertexArray(vertexArray));
+    m_VertexArray = vertexArray;
+    m_Buffers[GetBufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = Unknown; // Each vertex array brings its own index buffer binding
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindBuffer(unsigned int target, unsigned int buffer)
+{
+    int index = GetBufferTargetIndex(target);
+
+    if (index >= 0 && m_Buffers[index] == buffer)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    GLCall(glBindBuffer(target, buffer));
+    if (index >= 0)
+        m_Buffers[index] = buffer;
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer)
+{
+    int targetIndex = GetIndexedTargetIndex(target);
+    ASSERT(targetIndex >= 0 && index < MaxBufferBindings);
+
+    BufferRange& binding = m_IndexedBuffers[targetIndex][index];
+    if (binding.Buffer == buffer && binding.Offset == 0 && binding.Size == 0)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    GLCall(glBindBufferBase(target, index, buffer));
+    binding = { buffer, 0, 0 };
+    m_Buffers[GetBufferTargetIndex(target)] = buffer;
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size)
+{
+    int targetIndex = GetIndexedTargetIndex(target);
+    ASSERT(targetIndex >= 0 && index < MaxBufferBindings && size > 0);
+
+    BufferRange& binding = m_IndexedBuffers[targetIndex][index];
+    if (binding.Buffer == buffer && binding.Offset == offset && binding.Size == size)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    GLCall(glBindBufferRange(target, index, buffer, offset, size));
+    binding = { buffer, offset, size };
+    m_Buffers[GetBufferTargetIndex(target)] = buffer;
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindTexture(unsigned int slot, unsigned int target, unsigned int texture)
+{
+    ASSERT(slot < MaxTextureSlots);
+    int index = GetTextureTargetIndex(target);
+
+    if (index >= 0 && m_Textures[slot][index] == texture)
+    {
+        m_Stats.Hits++;
+        return;
+    }
+
+    if (m_ActiveTextureSlot != slot)
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+        m_ActiveTextureSlot = slot;
+        m_Stats.Misses++;
+    }
+
+    GLCall(glBindTexture(target, texture));
+    if (index >= 0)
+        m_Textures[slot][index] = texture;
+    m_Stats.Misses++;
+}
+
+void GLStateCache::BindTextureForEdit(unsigned int slot, unsigned int target, unsigned int texture)
+{
+    ASSERT(slot < MaxTextureSlots);
+
+    if (m_ActiveTextureSlot != slot)
+    {
+        GLCall(glActiveTexture(GL_TEXTURE0 + slot));
+        m_ActiveTextureSlot = slot;
+        m_Stats.Misses++;
+    }
+
+    BindTexture(slot, target, texture);
+}
+
+unsigned int GLStateCache::GetBoundTexture(unsigned int slot, unsigned int target) const
+{
+    ASSERT(slot < MaxTextureSlots);
+    int index = GetTextureTargetIndex(target);
+    if (index < 0 || m_Textures[slot][index] == Unknown)
+        return 0;
+
+    return m_Textures[slot][index];
+}
+
+void GLStateCache::OnDeleteProgram(unsigned int program)
+{
+    // A deleted program stays in use until another one is used, but its name may be handed out again
+    if (m_Program == program)
+        m_Program = Unknown;
+}
+
+void GLStateCache::OnDeleteFrameBuffer(unsigned int frameBuffer)
+{
+    if (m_FrameBuffer == frameBuffer)
+        m_FrameBuffer = 0;
+}
+
+void GLStateCache::OnDeleteVertexArray(unsigned int vertexArray)
+{
+    if (m_VertexArray == vertexArray)
+    {
+        m_VertexArray = 0;
+        m_Buffers[GetBufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+}
+
+void GLStateCache::OnDeleteBuffer(unsigned int buffer)
+{
+    for (auto& binding : m_Buffers)
+    {
+        if (binding == buffer)
+            binding = 0;
+    }
+
+    for (auto& target : m_IndexedBuffers)
+    {
+        for (auto& binding : target)
+        {
+            if (binding.Buffer == buffer)
+                binding = { 0, 0, 0 };
+        }
+    }
+}
+
+void GLStateCache::OnDeleteTexture(unsigned int texture)
+{
+    for (auto& slot : m_Textures)
+    {
+        for (auto& binding : slot)
+        {
+            if (binding == texture)
+                binding = 0;
+        }
+    }
+}
+
+void GLStateCache::Invalidate()
+{
+    m_Program = Unknown;
+    m_FrameBuffer = Unknown;
+    m_VertexArray = Unknown;
+    m_ActiveTextureSlot = Unknown;
+
+    for (auto& binding : m_Buffers)
+        binding = Unknown;
+
+    for (auto& target : m_IndexedBuffers)
+    {
+        for (auto& binding : target)
+            binding = { Unknown, 0, 0 };
+    }
+
+    for (auto& slot : m_Textures)
+    {
+        for (auto& binding : slot)
+            binding = Unknown;
+    }
+}
+
+int GLStateCache::GetBufferTargetIndex(unsigned int target)
+{
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER:           return 0;
+        case GL_ELEMENT_ARRAY_BUFFER:   return 1;
+        case GL_UNIFORM_BUFFER:         return 2;
+        case GL_DRAW_INDIRECT_BUFFER:   return 3;
+        case GL_SHADER_STORAGE_BUFFER:  return 4;
+    }
+
+    return -1; // Not tracked, always reaches the driver
+}
+
+int GLStateCache::GetTextureTargetIndex(unsigned int target)
+{
+    switch (target)
+    {
+        case GL_TEXTURE_2D:         return 0;
+        case GL_TEXTURE_2D_ARRAY:   return 1;
+    }
+
+    return -1;
+}
+
+int GLStateCache::GetIndexedTargetIndex(unsigned int target)
+{
+    switch (target)
+    {
+        case GL_UNIFORM_BUFFER:         return 0;
+        case GL_SHADER_STORAGE_BUFFER:  return 1;
+    }
+
+    return -1;
+}
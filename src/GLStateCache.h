@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+Hits are GL calls that were skipped because the state was already set, misses are calls that went to the driver.
+*/
+struct GLStateCacheStats
+{
+    unsigned int Hits = 0;
+    unsigned int Misses = 0;
+};
+
+/**
+Remembers the bindings of the OpenGL context so binding the same object twice doesn't reach the driver.
+Every bind in the renderer goes through here, raw GL binds outside of it should be followed by Invalidate().
+*/
+class GLStateCache
+{
+private:
+    static const unsigned int MaxTextureSlots = 32;
+    static const unsigned int BufferTargetCount = 5;
+    static const unsigned int TextureTargetCount = 2;
+    static const unsigned int IndexedTargetCount = 2;
+    static const unsigned int MaxBufferBindings = 36; // The minimum amount of uniform buffer bindings OpenGL 3.3 guarantees
+    static const unsigned int Unknown = 0xFFFFFFFF; // Forces the next bind to reach the driver
+
+    unsigned int m_Program;
+    unsigned int m_FrameBuffer;
+    unsigned int m_VertexArray;
+    unsigned int m_Buffers[BufferTargetCount];
+
+    /**
+        A buffer bound to a binding point of an indexed target, a size of 0 means the whole buffer.
+    */
+    struct BufferRange
+    {
+        unsigned int Buffer;
+        unsigned int Offset;
+        unsigned int Size;
+    };
+    BufferRange m_IndexedBuffers[IndexedTargetCount][MaxBufferBindings];
+    unsigned int m_ActiveTextureSlot;
+    unsigned int m_Textures[MaxTextureSlots][TextureTargetCount];
+    GLStateCacheStats m_Stats;
+public:
+    GLStateCache();
+
+    /**
+        Return the state cache of the context. The application uses a single context, switching contexts requires Invalidate().
+    */
+    static GLStateCache& Get();
+
+    void UseProgram(unsigned int program);
+    void BindFrameBuffer(unsigned int frameBuffer);
+    void BindVertexArray(unsigned int vertexArray);
+    void BindBuffer(unsigned int target, unsigned int buffer);
+
+    /**
+        Bind a whole buffer to a binding point of GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+        Like OpenGL, this also changes the regular binding of the target.
+
+        @param target The indexed target
+        @param index The binding point
+        @param buffer The buffer or 0 to unbind
+    */
+    void BindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+
+    /**
+        Bind part of a buffer to a binding point of GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+
+        @param target The indexed target
+        @param index The binding point
+        @param buffer The buffer
+        @param offset The start of the range in bytes, a multiple of the offset alignment of the target
+        @param size The size of the range in bytes
+    */
+    void BindBufferRange(unsigned int target, unsigned int index, unsigned int buffer, unsigned int offset, unsigned int size);
+
+    /**
+        Bind a texture to a texture slot, the active texture slot is only switched when the binding changes.
+
+        @param slot The texture unit, starting at 0
+        @param target The texture target, like GL_TEXTURE_2D
+        @param texture The texture or 0 to unbind
+    */
+    void BindTexture(unsigned int slot, unsigned int target, unsigned int texture);
+
+    /**
+        Bind a texture to change it with glTex* calls. These calls affect the active texture slot, so unlike BindTexture
+        this also switches the active slot when the texture is already bound to the slot.
+
+        @param slot The texture unit, starting at 0
+        @param target The texture target, like GL_TEXTURE_2D
+        @param texture The texture to change
+    */
+    void BindTextureForEdit(unsigned int slot, unsigned int target, unsigned int texture);
+
+    /**
+        Return the texture that is bound to a texture slot, to bind it again after a temporary bind.
+
+        @return The texture, 0 when nothing or an unknown texture is bound
+    */
+    unsigned int GetBoundTexture(unsigned int slot, unsigned int target) const;
+
+    // Deleting an object resets the bindings OpenGL resets, so a recycled name is bound again
+    void OnDeleteProgram(unsigned int program);
+    void OnDeleteFrameBuffer(unsigned int frameBuffer);
+    void OnDeleteVertexArray(unsigned int vertexArray);
+    void OnDeleteBuffer(unsigned int buffer);
+    void OnDeleteTexture(unsigned int texture);
+
+    /**
+        Forget all bindings, the next bind of everything reaches the driver.
+    */
+    void Invalidate();
+
+    inline unsigned int GetActiveTextureSlot() const { return m_ActiveTextureSlot; }
+    inline const GLStateCacheStats& GetStats() const { return m_Stats; }
+    inline void ResetStats() { m_Stats = GLStateCacheStats(); }
+private:
+    static int GetBufferTargetIndex(unsigned int target);
+    static int GetTextureTargetIndex(unsigned int target);
+    static int GetIndexedTargetIndex(unsigned int target);
+};
\ No newline at end of file
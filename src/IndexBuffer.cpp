@@ -1,27 +1,192 @@
 #include "IndexBuffer.h"
 #include "Renderer.h"
 
-IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
-    : m_Count(count)
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count, bool allowBytes)
+    : m_Count(count), m_Capacity(count), m_DataCount(count), m_Dynamic(false), m_AllowBytes(allowBytes)
 {
     ASSERT(sizeof(unsigned int) == sizeof(GLuint));
 
+    unsigned int maxIndex = count > 0 ? *std::max_element(data, data + count) : 0;
+    m_Type = GetTypeForMaxIndex(maxIndex, m_AllowBytes);
+
+    // Smaller indices use less memory and bandwidth, every vertex fetch reads one
+    std::vector<unsigned char> indices(count * GetIndexSize());
+    Encode(data, count, indices.data());
+
     GLCall(glGenBuffers(1, &m_RendererID)); // Generate a single buffer
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID)); // Select the buffer to be drawn
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW)); // Add the data to the buffer
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID); // Select the buffer to be drawn
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size(), indices.data(), GL_STATIC_DRAW)); // Add the data to the buffer
+}
+
+IndexBuffer::IndexBuffer(unsigned int capacity, bool allowBytes)
+    : m_Count(0), m_Capacity(capacity), m_DataCount(0), m_Type(allowBytes ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT),
+      m_Dynamic(true), m_AllowBytes(allowBytes), m_Data(capacity * GetSizeOfType(m_Type))
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Data.size(), nullptr, GL_DYNAMIC_DRAW)); // Only reserve the memory
 }
 
 IndexBuffer::~IndexBuffer()
 {
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
     GLCall(glDeleteBuffers(1, &m_RendererID));  
 }
 
+void IndexBuffer::SetData(const unsigned int* data, unsigned int count)
+{
+    ASSERT(m_Dynamic);
+
+    unsigned int maxIndex = count > 0 ? *std::max_element(data, data + count) : 0;
+    unsigned int type = GetTypeForMaxIndex(maxIndex, m_AllowBytes);
+    if (GetSizeOfType(type) > GetIndexSize())
+        m_Type = type; // All indices are replaced, no need to convert the old ones
+
+    m_Capacity = std::max(m_Capacity, count);
+    m_Data.resize(m_Capacity * GetIndexSize());
+    Encode(data, count, m_Data.data());
+    m_DirtyRanges.Clear(); // The pending changes are overwritten
+    m_Count = count;
+    m_DataCount = count; // The copy still holds older indices after these, but the storage is orphaned so they're gone
+
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Data.size(), nullptr, GL_DYNAMIC_DRAW)); // Orphan the storage that may still be in use
+    GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, count * GetIndexSize(), m_Data.data()));
+}
+
+void IndexBuffer::SetSubData(unsigned int offset, const unsigned int* data, unsigned int count)
+{
+    ASSERT(m_Dynamic && offset <= m_DataCount && offset + count <= m_Capacity);
+
+    unsigned int maxIndex = count > 0 ? *std::max_element(data, data + count) : 0;
+    unsigned int type = GetTypeForMaxIndex(maxIndex, m_AllowBytes);
+    if (GetSizeOfType(type) > GetIndexSize())
+        Widen(type);
+
+    Encode(data, count, &m_Data[offset * GetIndexSize()]);
+    m_DirtyRanges.Add(offset * GetIndexSize(), count * GetIndexSize());
+    m_DataCount = std::max(m_DataCount, offset + count);
+}
+
+unsigned int IndexBuffer::Upload()
+{
+    if (m_DirtyRanges.IsEmpty())
+        return 0;
+
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+
+    unsigned int uploaded = 0;
+    for (const DirtyRange& range : m_DirtyRanges.Merge())
+    {
+        GLCall(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, range.Offset, range.Size, &m_Data[range.Offset]));
+        uploaded += range.Size;
+    }
+
+    m_DirtyRanges.Clear();
+    return uploaded;
+}
+
+void IndexBuffer::SetCount(unsigned int count)
+{
+    ASSERT(count <= m_DataCount); // The indices after m_DataCount are undefined, a draw must not read them
+    m_Count = count;
+}
+
+void IndexBuffer::Resize(unsigned int capacity)
+{
+    ASSERT(m_Dynamic);
+
+    m_Capacity = capacity;
+    m_Count = std::min(m_Count, capacity);
+    m_DataCount = std::min(m_DataCount, capacity);
+    m_Data.resize(capacity * GetIndexSize());
+    m_DirtyRanges.Clear();
+
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Data.size(), m_Data.data(), GL_DYNAMIC_DRAW));
+}
+
 void IndexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+unsigned int IndexBuffer::GetTypeForMaxIndex(unsigned int maxIndex, bool allowBytes)
+{
+    if (allowBytes && maxIndex <= 0xFF)
+        return GL_UNSIGNED_BYTE;
+    if (maxIndex <= 0xFFFF)
+        return GL_UNSIGNED_SHORT;
+    return GL_UNSIGNED_INT;
+}
+
+unsigned int IndexBuffer::GetSizeOfType(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_UNSIGNED_BYTE:  return 1;
+        case GL_UNSIGNED_SHORT: return 2;
+        case GL_UNSIGNED_INT:   return 4;
+    }
+    ASSERT(false);
+    return 0;
+}
+
+void IndexBuffer::Encode(const unsigned int* indices, unsigned int count, unsigned char* destination) const
+{
+    switch (m_Type)
+    {
+        case GL_UNSIGNED_BYTE:
+            for (unsigned int i = 0; i < count; i++)
+                destination[i] = (uint8_t)indices[i];
+            break;
+        case GL_UNSIGNED_SHORT:
+            for (unsigned int i = 0; i < count; i++)
+            {
+                uint16_t index = (uint16_t)indices[i];
+                std::memcpy(destination + i * 2, &index, 2);
+            }
+            break;
+        default:
+            std::memcpy(destination, indices, count * 4);
+            break;
+    }
+}
+
+void IndexBuffer::Widen(unsigned int type)
+{
+    // Decode the current indices, they become the source of the new encoding
+    unsigned int size = GetIndexSize();
+    std::vector<unsigned int> indices(m_Capacity);
+    for (unsigned int i = 0; i < m_Capacity; i++)
+    {
+        if (size == 1)
+        {
+            indices[i] = m_Data[i];
+        }
+        else
+        {
+            uint16_t index;
+            std::memcpy(&index, &m_Data[i * 2], 2);
+            indices[i] = index;
+        }
+    }
+
+    m_Type = type;
+    m_Data.resize(m_Capacity * GetIndexSize());
+    Encode(indices.data(), m_Capacity, m_Data.data());
+
+    // The whole buffer changes, including the ranges that were waiting for an upload
+    m_DirtyRanges.Clear();
+    GLStateCache::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Data.size(), m_Data.data(), GL_DYNAMIC_DRAW));
 }
@@ -1,16 +1,105 @@
 #pragma once
 
+#include <vector>
+
+#include "DirtyRangeList.h"
+
+/**
+Indices are stored with the smallest type that fits the largest index: 16 bits below 65536 vertices and 32 bits otherwise.
+8 bit indices are opt-in, many drivers convert them on the CPU before drawing. Draw calls use GetType instead of assuming GL_UNSIGNED_INT.
+*/
 class IndexBuffer
 {
 private:
     unsigned int m_RendererID;
     unsigned int m_Count;
+    unsigned int m_Capacity;
+    unsigned int m_DataCount; // The indices at the start that hold data, the rest is undefined
+    unsigned int m_Type;
+    bool m_Dynamic;
+    bool m_AllowBytes; // Whether 8 bit indices may be used
+    std::vector<unsigned char> m_Data; // A copy of the indices of a dynamic buffer in m_Type, SetSubData writes here first
+    DirtyRangeList m_DirtyRanges;
 public:
-    IndexBuffer(const unsigned int* data, unsigned int count);
+    /**
+        @param data The indices
+        @param count The amount of indices
+        @param allowBytes Store the indices in 8 bits when the largest one is below 256
+    */
+    IndexBuffer(const unsigned int* data, unsigned int count, bool allowBytes = false);
+
+    /**
+        Create an empty dynamic buffer that is filled later on with SetData or SetSubData.
+        It starts with 16 bit indices, or 8 bit ones when allowed, and widens the type when a larger index is written, it never narrows.
+
+        @param capacity The amount of indices the buffer can hold, the count starts at 0
+        @param allowBytes Start with 8 bit indices
+    */
+    IndexBuffer(unsigned int capacity, bool allowBytes = false);
     ~IndexBuffer();
 
+    /**
+        Replace the indices and upload them right away, the buffer grows when they don't fit.
+        The indices after them are undefined afterwards.
+
+        @param data The indices
+        @param count The amount of indices, the new count of the buffer
+    */
+    void SetData(const unsigned int* data, unsigned int count);
+
+    /**
+        Change part of a dynamic buffer. Nothing is uploaded until Upload, so many small changes cost a few uploads.
+        The change has to start inside of or right after the indices, so no undefined indices are left in between.
+
+        @param offset The index of the first index to change
+        @param data The new indices
+        @param count The amount of indices
+    */
+    void SetSubData(unsigned int offset, const unsigned int* data, unsigned int count);
+
+    /**
+        Upload the ranges of a dynamic buffer that were changed with SetSubData since the last upload.
+
+        @return The amount of bytes that were uploaded
+    */
+    unsigned int Upload();
+
+    /**
+        Change the amount of indices that are drawn, at most the amount of indices that hold data.
+    */
+    void SetCount(unsigned int count);
+
+    /**
+        Change the capacity of a dynamic buffer, the indices that fit in the new capacity are kept.
+    */
+    void Resize(unsigned int capacity);
+
     void Bind() const;
     void Unbind() const;
 
     inline unsigned int GetCount() const { return m_Count; }
+    inline unsigned int GetCapacity() const { return m_Capacity; }
+
+    /**
+        The type to pass to glDrawElements: GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+    */
+    inline unsigned int GetType() const { return m_Type; }
+    inline unsigned int GetIndexSize() const { return GetSizeOfType(m_Type); }
+
+    /**
+        The smallest index type that can hold the given index, GL_UNSIGNED_BYTE only when allowed.
+    */
+    static unsigned int GetTypeForMaxIndex(unsigned int maxIndex, bool allowBytes = false);
+    static unsigned int GetSizeOfType(unsigned int type);
+private:
+
+    /**
+        Convert indices to the type of the buffer.
+    */
+    void Encode(const unsigned int* indices, unsigned int count, unsigned char* destination) const;
+
+    /**
+        Switch a dynamic buffer to a larger type, the indices are converted and uploaded again.
+    */
+    void Widen(unsigned int type);
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "IndirectBuffer.h"
+#include "Renderer.h"
+
+IndirectBuffer::IndirectBuffer()
+    : m_RendererID(0), m_Capacity(0), m_IndexType(GL_UNSIGNED_INT), m_UploadedCount(0), m_Indirect(GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect)
+{
+    if (m_Indirect)
+    {
+        GLCall(glGenBuffers(1, &m_RendererID));
+    }
+}
+
+IndirectBuffer::~IndirectBuffer()
+{
+    if (m_Indirect)
+    {
+        GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+        GLCall(glDeleteBuffers(1, &m_RendererID));
+    }
+}
+
+void IndirectBuffer::Add(unsigned int indexCount, unsigned int firstIndex, int baseVertex, unsigned int instanceCount)
+{
+    m_Commands.push_back({ indexCount, instanceCount, firstIndex, baseVertex, 0 });
+}
+
+void IndirectBuffer::Upload(unsigned int indexType)
+{
+    m_IndexType = indexType;
+    m_UploadedCount = (unsigned int)m_Commands.size();
+
+    if (!m_Indirect)
+    {
+        // Split the commands into the separate arrays glMultiDrawElementsBaseVertex takes
+        m_Counts.resize(m_Commands.size());
+        m_Offsets.resize(m_Commands.size());
+        m_BaseVertices.resize(m_Commands.size());
+
+        for (unsigned int i = 0; i < m_Commands.size(); i++)
+        {
+            m_Counts[i] = m_Commands[i].Count;
+            m_Offsets[i] = (void*)((size_t)m_Commands[i].FirstIndex * IndexBuffer::GetSizeOfType(indexType));
+            m_BaseVertices[i] = m_Commands[i].BaseVertex;
+        }
+
+        return;
+    }
+
+    unsigned int size = (unsigned int)(m_Commands.size() * sizeof(DrawElementsIndirectCommand));
+    GLStateCache::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+
+    // Grow the storage when needed, otherwise orphan it and reuse the same size
+    if (size > m_Capacity)
+        m_Capacity = size;
+    GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER, m_Capacity, nullptr, GL_DYNAMIC_DRAW));
+    GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size, m_Commands.data()));
+}
+
+void IndirectBuffer::Submit() const
+{
+    if (m_UploadedCount == 0)
+        return;
+
+    if (m_Indirect)
+    {
+        GLStateCache::Get().BindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID);
+        GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, m_IndexType, nullptr, (GLsizei)m_UploadedCount, 0));
+    }
+    else
+    {
+        // This version of GLEW declares the arrays as non-const, they are only read
+        GLCall(glMultiDrawElementsBaseVertex(GL_TRIANGLES, const_cast<int*>(m_Counts.data()), m_IndexType, const_cast<void**>(m_Offsets.data()), (GLsizei)m_UploadedCount, const_cast<int*>(m_BaseVertices.data())));
+    }
+}
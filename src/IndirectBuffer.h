@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+/**
+The layout OpenGL expects for a single draw in an indirect buffer.
+*/
+struct DrawElementsIndirectCommand
+{
+    unsigned int Count;
+    unsigned int InstanceCount;
+    unsigned int FirstIndex;
+    int BaseVertex;
+    unsigned int BaseInstance;
+};
+
+/**
+A list of draws into shared vertex and index buffers that is submitted with a single call.
+Without OpenGL 4.3 the draws are kept on the CPU and submitted with glMultiDrawElementsBaseVertex instead.
+*/
+class IndirectBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Capacity;
+    unsigned int m_IndexType;
+    unsigned int m_UploadedCount; // The draws that Submit submits, added draws wait for the next Upload
+    bool m_Indirect;
+    std::vector<DrawElementsIndirectCommand> m_Commands;
+
+    // The arguments of the glMultiDrawElementsBaseVertex fallback
+    std::vector<int> m_Counts;
+    std::vector<void*> m_Offsets;
+    std::vector<int> m_BaseVertices;
+public:
+    IndirectBuffer();
+    ~IndirectBuffer();
+
+    /**
+        Add a draw of a mesh in the shared buffers.
+
+        @param indexCount The amount of indices of the mesh
+        @param firstIndex The position of the first index of the mesh in the index buffer
+        @param baseVertex The value added to every index, the position of the first vertex of the mesh
+        @param instanceCount The amount of instances, the fallback path always draws a single instance
+    */
+    void Add(unsigned int indexCount, unsigned int firstIndex, int baseVertex, unsigned int instanceCount = 1);
+
+    /**
+        Upload the draws that were added since the last clear.
+
+        @param indexType The type of the index buffer the draws read from, IndexBuffer::GetType
+    */
+    void Upload(unsigned int indexType);
+
+    inline void Clear() { m_Commands.clear(); }
+
+    /**
+        Submit the draws of the last upload, the vertex array, index buffer and shader should be bound.
+    */
+    void Submit() const;
+
+    inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+    inline unsigned int GetUploadedCount() const { return m_UploadedCount; }
+    inline unsigned int GetIndexType() const { return m_IndexType; }
+    inline bool IsIndirect() const { return m_Indirect; }
+};
\ No newline at end of file
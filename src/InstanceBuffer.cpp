@@ -0,0 +1,35 @@
+#include "InstanceBuffer.h"
+#include "VertexBufferLayout.h"
+#include "Renderer.h"
+
+InstanceBuffer::InstanceBuffer(unsigned int maxInstances)
+    : m_MaxInstances(maxInstances), m_VertexBuffer(maxInstances * sizeof(InstanceData))
+{
+    m_Instances.reserve(maxInstances);
+}
+
+void InstanceBuffer::AddTo(VertexArray& va) const
+{
+    VertexBufferLayout layout;
+    layout.Push<glm::mat4>(1); // transform
+    layout.Push<float>(4); // color
+    layout.SetDivisor(1);
+
+    va.AddBuffer(m_VertexBuffer, layout);
+}
+
+void InstanceBuffer::Add(const glm::mat4& transform, const glm::vec4& color)
+{
+    if (m_Instances.size() == m_MaxInstances)
+        return;
+
+    m_Instances.push_back({ transform, color });
+}
+
+void InstanceBuffer::Upload()
+{
+    if (m_Instances.empty())
+        return;
+
+    m_VertexBuffer.SetData(m_Instances.data(), (unsigned int)(m_Instances.size() * sizeof(InstanceData)));
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include "VertexBuffer.h"
+#include "VertexArray.h"
+
+#include "glm/glm.hpp"
+
+/**
+The per instance attributes, the transform uses locations 2 to 5 and the color location 6 in Instanced.shader.
+*/
+struct InstanceData
+{
+    glm::mat4 Transform;
+    glm::vec4 Color;
+};
+
+/**
+A buffer with per instance data that is filled on the CPU and streamed to the GPU every frame.
+*/
+class InstanceBuffer
+{
+private:
+    unsigned int m_MaxInstances;
+    VertexBuffer m_VertexBuffer;
+    std::vector<InstanceData> m_Instances;
+public:
+    /**
+        Create the buffer for instanced drawing.
+
+        @param maxInstances The amount of instances the buffer can hold
+    */
+    InstanceBuffer(unsigned int maxInstances);
+
+    /**
+        Attach the per instance attributes after the vertex attributes of the vertex array.
+
+        @param va The vertex array that holds the mesh that is instanced
+    */
+    void AddTo(VertexArray& va) const;
+
+    /**
+        Add an instance, instances beyond the maximum are dropped.
+
+        @param transform The model matrix of the instance
+        @param color The color of the instance
+    */
+    void Add(const glm::mat4& transform, const glm::vec4& color);
+
+    /**
+        Upload the instances that were added since the last clear.
+    */
+    void Upload();
+
+    inline void Clear() { m_Instances.clear(); }
+    inline unsigned int GetCount() const { return (unsigned int)m_Instances.size(); }
+};
\ No newline at end of file
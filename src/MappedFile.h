@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+A file that is mapped into memory for reading, its contents can be viewed without copying them.
+The view stays valid as long as the mapped file exists.
+*/
+class MappedFile
+{
+private:
+    const char* m_Data;
+    size_t m_Size;
+#ifdef _WIN32
+    void* m_File;
+    void* m_Mapping;
+#endif
+public:
+    /**
+        Map a file, an empty or missing file gives an empty view.
+
+        @param filePath Path to the file
+    */
+    MappedFile(const std::string& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    inline bool IsOpen() const { return m_Data != nullptr; }
+    inline std::string_view GetView() const { return { m_Data, m_Size }; }
+};
\ No newline at end of file
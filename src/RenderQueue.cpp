@@ -0,0 +1,161 @@
+#include "RenderQueue.h"
+#include "Renderer.h"
+
+#include <algorithm>
+
+void RenderCommandBuffer::Submit(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Texture* texture, unsigned char layer, float depth)
+{
+    RenderCommand command = { &va, &ib, &shader, texture };
+
+    m_Entries.push_back({ CreateKey(command, layer, depth), (uint32_t)m_Commands.size() });
+    m_Commands.push_back(command);
+}
+
+void RenderCommandBuffer::Clear()
+{
+    m_Commands.clear();
+    m_Entries.clear();
+}
+
+uint64_t RenderCommandBuffer::CreateKey(const RenderCommand& command, unsigned char layer, float depth)
+{
+    // OpenGL hands out small names, so the low bits of a name are enough to group the same objects
+    uint64_t shader = command.Program->GetRendererID() & 0xFFF;
+    uint64_t texture = command.Tex ? command.Tex->GetRendererID() & 0xFFF : 0;
+    uint64_t vertexArray = command.VA->GetRendererID() & 0xFFF;
+    uint64_t quantizedDepth = (uint64_t)(std::min(std::max(depth, 0.0f), 1.0f) * 0xFFFFF);
+
+    return ((uint64_t)layer << 56) | (shader << 44) | (texture << 32) | (vertexArray << 20) | quantizedDepth;
+}
+
+void RenderQueue::Submit(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Texture* texture, unsigned char layer, float depth)
+{
+    m_Buffer.Submit(va, ib, shader, texture, layer, depth);
+}
+
+void RenderQueue::Merge(RenderCommandBuffer& buffer)
+{
+    // The indices of the merged entries point past the commands that are already queued
+    uint32_t offset = (uint32_t)m_Buffer.m_Commands.size();
+
+    m_Buffer.m_Commands.insert(m_Buffer.m_Commands.end(), buffer.m_Commands.begin(), buffer.m_Commands.end());
+    for (const auto& entry : buffer.m_Entries)
+        m_Buffer.m_Entries.push_back({ entry.Key, entry.Index + offset });
+
+    buffer.Clear();
+}
+
+void RenderQueue::Flush()
+{
+    m_Stats = RenderQueueStats();
+    m_Stats.Commands = m_Buffer.GetCount();
+    m_Stats.SubmittedStateChanges = CountStateChanges();
+
+    SortEntries();
+
+    m_Stats.SortedStateChanges = CountStateChanges();
+
+    const VertexArray* currentVertexArray = nullptr;
+    const IndexBuffer* currentIndexBuffer = nullptr;
+    const Shader* currentShader = nullptr;
+    const Texture* currentTexture = nullptr;
+
+    // Only bind what differs from the previous command
+    for (const auto& entry : m_Buffer.m_Entries)
+    {
+        const RenderCommand& command = m_Buffer.m_Commands[entry.Index];
+
+        if (command.Program != currentShader)
+        {
+            command.Program->Bind();
+            currentShader = command.Program;
+        }
+
+        if (command.Tex && command.Tex != currentTexture)
+        {
+            command.Tex->Bind();
+            currentTexture = command.Tex;
+        }
+
+        if (command.VA != currentVertexArray)
+        {
+            command.VA->Bind();
+            currentVertexArray = command.VA;
+            currentIndexBuffer = nullptr; // The index buffer binding is part of the vertex array state
+        }
+
+        if (command.IB != currentIndexBuffer)
+        {
+            command.IB->Bind();
+            currentIndexBuffer = command.IB;
+        }
+
+        GLCall(glDrawElements(GL_TRIANGLES, command.IB->GetCount(), command.IB->GetType(), nullptr));
+    }
+
+    m_Buffer.Clear();
+}
+
+void RenderQueue::SortEntries()
+{
+    std::vector<RenderSortEntry>& entries = m_Buffer.m_Entries;
+    m_SortBuffer.resize(entries.size());
+
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        unsigned int counts[256] = {};
+        for (const auto& entry : entries)
+            counts[(entry.Key >> shift) & 0xFF]++;
+
+        // Skip the pass when every key has the same byte here, which is common for the unused high bits
+        if (counts[(entries.empty() ? 0 : (entries[0].Key >> shift) & 0xFF)] == entries.size())
+            continue;
+
+        unsigned int offsets[256];
+        unsigned int offset = 0;
+        for (unsigned int i = 0; i < 256; i++)
+        {
+            offsets[i] = offset;
+            offset += counts[i];
+        }
+
+        // Scatter in order, so the sort is stable and the submission order is kept for equal keys
+        for (const auto& entry : entries)
+            m_SortBuffer[offsets[(entry.Key >> shift) & 0xFF]++] = entry;
+
+        entries.swap(m_SortBuffer);
+    }
+}
+
+unsigned int RenderQueue::CountStateChanges() const
+{
+    const VertexArray* currentVertexArray = nullptr;
+    const Shader* currentShader = nullptr;
+    const Texture* currentTexture = nullptr;
+    unsigned int changes = 0;
+
+    for (const auto& entry : m_Buffer.m_Entries)
+    {
+        const RenderCommand& command = m_Buffer.m_Commands[entry.Index];
+
+        if (command.Program != currentShader)
+        {
+            currentShader = command.Program;
+            changes++;
+        }
+
+        if (command.Tex && command.Tex != currentTexture)
+        {
+            currentTexture = command.Tex;
+            changes++;
+        }
+
+        if (command.VA != currentVertexArray)
+        {
+            currentVertexArray = command.VA;
+            changes++;
+        }
+    }
+
+    return changes;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "VertexArray.h"
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "Texture.h"
+
+/**
+A recorded draw, the state it needs is executed once the queue is flushed.
+*/
+struct RenderCommand
+{
+    const VertexArray* VA;
+    const IndexBuffer* IB;
+    const Shader* Program;
+    const Texture* Tex; // nullptr when the draw doesn't sample a texture
+};
+
+/**
+A sort key with the index of the command it belongs to, so only 12 bytes move around while sorting.
+*/
+struct RenderSortEntry
+{
+    uint64_t Key;
+    uint32_t Index;
+};
+
+/**
+Statistics about the last flush of the queue.
+*/
+struct RenderQueueStats
+{
+    unsigned int Commands = 0;
+    unsigned int SubmittedStateChanges = 0; // Program, texture and vertex array switches in submission order
+    unsigned int SortedStateChanges = 0; // The same switches after sorting
+
+    // Negative when the sorted order switches more often, for example when the draws were already grouped by shader
+    inline int GetSavedStateChanges() const { return (int)SubmittedStateChanges - (int)SortedStateChanges; }
+};
+
+/**
+Records draws without touching OpenGL, so every worker thread can fill its own buffer.
+The buffers are merged into a RenderQueue on the thread that owns the context.
+*/
+class RenderCommandBuffer
+{
+private:
+    friend class RenderQueue;
+
+    std::vector<RenderCommand> m_Commands;
+    std::vector<RenderSortEntry> m_Entries;
+public:
+    /**
+        Record a draw without executing it.
+
+        @param va The vertex array to draw
+        @param ib The indices to draw
+        @param shader The shader to draw with, uniforms should be set before the queue is flushed
+        @param texture The texture bound to slot 0 or nullptr
+        @param layer The layer, lower layers are drawn first
+        @param depth The depth between 0.0 and 1.0 inside of the layer, lower depths are drawn first
+    */
+    void Submit(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Texture* texture = nullptr, unsigned char layer = 0, float depth = 0.0f);
+
+    void Clear();
+
+    inline unsigned int GetCount() const { return (unsigned int)m_Commands.size(); }
+private:
+
+    /**
+        Pack the state of a command into a key, from most to least significant:
+        layer (8 bits), shader (12 bits), texture (12 bits), vertex array (12 bits), depth (20 bits).
+    */
+    static uint64_t CreateKey(const RenderCommand& command, unsigned char layer, float depth);
+};
+
+class RenderQueue
+{
+private:
+    RenderCommandBuffer m_Buffer;
+    std::vector<RenderSortEntry> m_SortBuffer;
+    RenderQueueStats m_Stats;
+public:
+    /**
+        Record a draw on the queue itself, see RenderCommandBuffer::Submit.
+    */
+    void Submit(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const Texture* texture = nullptr, unsigned char layer = 0, float depth = 0.0f);
+
+    /**
+        Move the commands of a worker's buffer to the end of the queue and clear the buffer.
+        Merge the buffers in the same order every frame, so equal keys keep a stable order.
+
+        @param buffer The recorded commands
+    */
+    void Merge(RenderCommandBuffer& buffer);
+
+    /**
+        Sort the recorded commands so state changes are grouped, execute them and clear the queue.
+    */
+    void Flush();
+
+    inline const RenderQueueStats& GetStats() const { return m_Stats; }
+private:
+
+    /**
+        Sort the entries by key with a least significant digit radix sort, one byte per pass.
+    */
+    void SortEntries();
+
+    /**
+        Count the program, texture and vertex array switches needed to draw the commands in the order of the entries.
+    */
+    unsigned int CountStateChanges() const;
+};
\ No newline at end of file
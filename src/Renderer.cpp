@@ -27,11 +27,49 @@ void Renderer::Clear() const
 
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const
 {
-    // Bind everything so we can draw
+    ASSERT(shader.ValidateVertexArray(va)); // Every attribute of the shader needs a buffer
+
+    // Bind everything so we can draw, the state cache skips what is already bound
     shader.Bind();
     va.Bind();
     ib.Bind();
     
     // Draw the current selected buffer
-    GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr)); // nullptr, because the indices are bound to the current buffer: GL_ELEMENT_ARRAY_BUFFER
+    GLCall(glDrawElements(GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr)); // nullptr, because the indices are bound to the current buffer: GL_ELEMENT_ARRAY_BUFFER
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const
+{
+    ASSERT(shader.ValidateVertexArray(va));
+
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+
+    GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(), ib.GetType(), nullptr, instanceCount));
+}
+
+void Renderer::MultiDrawIndirect(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const IndirectBuffer& commands) const
+{
+    ASSERT(shader.ValidateVertexArray(va));
+
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+
+    ASSERT(commands.GetIndexType() == ib.GetType()); // The commands were uploaded for a different index buffer
+    commands.Submit();
+}
+
+void Renderer::Dispatch(const Shader& shader, unsigned int x, unsigned int y, unsigned int z, unsigned int barriers) const
+{
+    ASSERT(shader.IsCompute());
+
+    shader.Bind();
+
+    GLCall(glDispatchCompute(x, y, z));
+    if (barriers)
+    {
+        GLCall(glMemoryBarrier(barriers));
+    }
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "GLStateCache.h"
+#include "IndirectBuffer.h"
 
 #define ASSERT(x) if (!(x)) __debugbreak(); // Break debugging if x returns false
 #define GLCall(x) GLClearError(); x; ASSERT(GLLogCall(#x, __FILE__, __LINE__)); // Wrap a function with an error boundary
@@ -29,4 +31,35 @@ class Renderer
 public:
     void Clear() const;
     void Draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+
+    /**
+        Draw the same indices multiple times with a single draw call, per instance attributes advance every instance.
+
+        @param va The vertex array with the vertex and instance buffers
+        @param ib The indices of a single instance
+        @param shader The shader to draw with
+        @param instanceCount The amount of instances to draw
+    */
+    void DrawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const;
+
+    /**
+        Draw many meshes that share the same buffers with a single call.
+
+        @param va The vertex array with the shared vertices of all meshes
+        @param ib The shared indices of all meshes
+        @param shader The shader to draw with
+        @param commands The uploaded draws of the meshes
+    */
+    void MultiDrawIndirect(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, const IndirectBuffer& commands) const;
+
+    /**
+        Run a compute shader, then wait with a memory barrier until its writes are visible to the next commands.
+        Bind the storage buffers the shader reads and writes before dispatching.
+
+        @param shader The compute shader
+        @param x, y, z The amount of work groups in each dimension, see Shader::GetWorkGroupSize
+        @param barriers How the written data is used next, the default covers storage blocks and vertex attributes
+    */
+    void Dispatch(const Shader& shader, unsigned int x, unsigned int y = 1, unsigned int z = 1,
+                  unsigned int barriers = GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT) const;
 };
\ No newline at end of file
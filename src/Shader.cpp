@@ -1,62 +1,261 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <unordered_map>
 
 #include "Shader.h"
 #include "Renderer.h"
+#include "VertexArray.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "MappedFile.h"
 
-Shader::Shader(const std::string & filePath)
-    : m_FilePath(filePath), m_RendererID(0)
+static const unsigned int s_StageTypes[ShaderStageCount] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER, GL_COMPUTE_SHADER };
+static const char* s_StageNames[ShaderStageCount] = { "vertex", "fragment", "geometry", "compute" };
+
+/**
+Take the next line off of a text.
+
+@param text The text, the line is removed from its front
+@param line Set to the line without its newline
+@return Whether there was a line left
+*/
+static bool NextLine(std::string_view& text, std::string_view& line)
 {
-    ShaderProgramSource source = ParseShader(filePath);
-    m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    if (text.empty())
+        return false;
+
+    size_t end = std::min(text.find('\n'), text.size());
+    line = text.substr(0, end);
+    text.remove_prefix(std::min(end + 1, text.size()));
+    return true;
 }
 
-Shader::~Shader()
+/**
+Find the path of an #include line.
+
+@param line A line of a shader
+@param path Set to the path between the quotes
+@return Whether the line is an include
+*/
+static bool ParseInclude(std::string_view line, std::string_view& path)
 {
-    GLCall(glDeleteProgram(m_RendererID));
+    size_t start = line.find_first_not_of(" \t");
+    if (start == std::string_view::npos || line.compare(start, 8, "#include") != 0)
+        return false;
+
+    size_t open = line.find('"', start + 8);
+    size_t close = open == std::string_view::npos ? open : line.find('"', open + 1);
+    if (close == std::string_view::npos)
+        return false;
+
+    path = line.substr(open + 1, close - open - 1);
+    return true;
 }
 
-ShaderProgramSource Shader::ParseShader(const std::string filePath)
+/**
+The directory of a file including the last slash, includes are relative to it.
+*/
+static std::string GetDirectory(const std::string& filePath)
 {
-    std::ifstream stream(filePath);
+    size_t slash = filePath.find_last_of("/\\");
+    return slash == std::string::npos ? "" : filePath.substr(0, slash + 1);
+}
+
+/**
+Add the lines of an included file to a stage, resolving the includes inside of it as well.
+Every file is added once per stage, as if it had an include guard.
 
-    enum class Shadertype
+@param filePath Path to the included file
+@param expanded The source of the stage
+@param included The files that were already added to this stage
+*/
+static void AppendInclude(const std::string& filePath, std::string& expanded, std::vector<std::string>& included)
+{
+    if (std::find(included.begin(), included.end(), filePath) != included.end())
+        return;
+    included.push_back(filePath);
+
+    MappedFile file(filePath);
+    if (!file.IsOpen())
+    {
+        std::cout << "Failed to include " << filePath << "!" << std::endl;
+        return;
+    }
+
+    std::string_view text = file.GetView(), line, include;
+    while (NextLine(text, line))
     {
-        NONE = -1, VERTEX = 0, FRAGMENT = 1
-    };
+        if (ParseInclude(line, include))
+            AppendInclude(GetDirectory(filePath) + std::string(include), expanded, included);
+        else
+            expanded.append(line.data(), line.size()).push_back('\n');
+    }
+}
+
+/**
+Resolve the includes of a stage and add the defines after its #version line.
+
+@param source The source of the stage
+@param directory The directory of the shader file, includes are relative to it
+@param defines The defines of the variant
+@param expanded Holds the new source when the stage had to change
+@return The source to compile, the original when there was nothing to do
+*/
+static std::string_view PreprocessStage(std::string_view source, const std::string& directory, const std::vector<std::string>& defines, std::string& expanded)
+{
+    if (source.empty() || (defines.empty() && source.find("#include") == std::string_view::npos))
+        return source;
+
+    expanded.reserve(source.size());
+    std::vector<std::string> included;
+    std::string_view text = source, line, include;
+    bool versionFound = false;
+    while (NextLine(text, line))
+    {
+        if (ParseInclude(line, include))
+        {
+            AppendInclude(directory + std::string(include), expanded, included);
+            continue;
+        }
+
+        expanded.append(line.data(), line.size()).push_back('\n');
+
+        // The defines of a variant have to follow the #version line, which has to come first.
+        // A line that only mentions #version, like a comment, is not the directive.
+        size_t start = line.find_first_not_of(" \t");
+        if (!versionFound && start != std::string_view::npos && line.compare(start, 8, "#version") == 0)
+        {
+            versionFound = true;
+            for (const std::string& define : defines)
+                expanded.append("#define ").append(define).push_back('\n');
+        }
+    }
+
+    // A stage without a #version line still gets its defines, they go before its first line
+    if (!versionFound && !defines.empty())
+    {
+        std::string header;
+        for (const std::string& define : defines)
+            header.append("#define ").append(define).push_back('\n');
+        expanded.insert(0, header);
+    }
+
+    return expanded;
+}
+
+Shader::Shader(const std::string & filePath, bool async)
+    : Shader(filePath, {}, async)
+{
+}
 
-    std::string line;
-    std::stringstream ss[2]; // 2 for vertex and fragment shaders
-    Shadertype type = Shadertype::NONE;
+Shader::Shader(const std::string& filePath, const std::vector<std::string>& defines, bool async)
+    : m_FilePath(filePath), m_RendererID(0), m_Compute(false), m_WorkGroupSize(0), m_UniformCount(0), m_UniformUploads(0),
+      m_Pending(false), m_Stages{}, m_CacheKey(0), m_Fallback(nullptr)
+{
+    MappedFile file(filePath);
+    if (!file.IsOpen())
+        std::cout << "Failed to open " << filePath << "!" << std::endl;
+
+    ShaderProgramSource source = ParseShader(file.GetView());
+    m_Compute = !source.Get(ShaderStage::Compute).empty();
+
+    // Stages with includes or defines are expanded into new strings, the others are compiled straight from the file
+    std::string expanded[ShaderStageCount];
+    for (unsigned int i = 0; i < ShaderStageCount; i++)
+        source.Sources[i] = PreprocessStage(source.Sources[i], GetDirectory(filePath), defines, expanded[i]);
+
+    m_RendererID = CreateShader(source);
+
+    if (m_Pending && async)
+        ShaderCompiler::Get().Add(*this);
+    else
+        FinishShader();
+}
 
-    while (getline(stream, line))
+Shader::~Shader()
+{
+    if (m_Pending)
     {
-        // Set the type if #shader is found
-        if (line.find("#shader") != std::string::npos)
+        ShaderCompiler::Get().Remove(*this);
+        for (unsigned int stage : m_Stages)
         {
-            if (line.find("vertex") != std::string::npos)
-                type = Shadertype::VERTEX;
-            else if (line.find("fragment") != std::string::npos)
-                type = Shadertype::FRAGMENT;
+            if (stage)
+            {
+                GLCall(glDeleteShader(stage));
+            }
         }
-        else // Add the line to the source
+    }
+
+    GLStateCache::Get().OnDeleteProgram(m_RendererID);
+    GLCall(glDeleteProgram(m_RendererID));
+}
+
+ShaderProgramSource Shader::ParseShader(std::string_view file)
+{
+    ShaderProgramSource source;
+    int stage = -1; // Text before the first marker and in unknown stages belongs to no stage
+    bool first = true;
+    size_t sectionStart = 0;
+    size_t position = 0;
+
+    // Jump from marker to marker, the lines in between are never looked at
+    while (true)
+    {
+        size_t marker = file.find("#shader", position);
+        if (marker == std::string_view::npos)
+            break;
+
+        // Only a marker at the start of a line counts
+        size_t lineStart = marker;
+        while (lineStart > 0 && (file[lineStart - 1] == ' ' || file[lineStart - 1] == '\t'))
+            lineStart--;
+        size_t lineEnd = std::min(file.find('\n', marker), file.size());
+        position = lineEnd;
+        if (lineStart > 0 && file[lineStart - 1] != '\n')
+            continue;
+
+        if (stage >= 0)
+            source.Sources[stage] = file.substr(sectionStart, lineStart - sectionStart);
+        else if (first && file.substr(0, lineStart).find_first_not_of(" \t\r\n") != std::string_view::npos)
+            std::cout << "Warning: the text before the first #shader line is skipped!" << std::endl;
+        first = false;
+
+        std::string_view name = file.substr(marker + 7, lineEnd - marker - 7);
+        stage = -1;
+        for (unsigned int i = 0; i < ShaderStageCount; i++)
         {
-            ss[(int)type] << line << '\n';
+            if (name.find(s_StageNames[i]) != std::string_view::npos)
+                stage = i;
         }
+
+        if (stage == -1)
+            std::cout << "Warning: unknown shader stage \"" << name << "\", it's skipped!" << std::endl;
+
+        sectionStart = std::min(lineEnd + 1, file.size());
     }
 
-    return { ss[0].str(), ss[1].str() };
+    if (stage >= 0)
+        source.Sources[stage] = file.substr(sectionStart);
+
+    return source;
 }
 
-unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+unsigned int Shader::CompileShader(unsigned int type, std::string_view source)
 {
     unsigned int id = glCreateShader(type); // Create the shader
-    const char* src = source.c_str(); // Return the pointer of the first character of the source
-    GLCall(glShaderSource(id, 1, &src, nullptr)); // Specify the shader source code
-    GLCall(glCompileShader(id));
+    const char* src = source.data(); // The source is a view, so its length is passed along
+    int length = (int)source.size();
+    GLCall(glShaderSource(id, 1, &src, &length)); // Specify the shader source code
+    GLCall(glCompileShader(id)); // Asking for the status now would wait for the compiler
 
+    return id;
+}
+
+bool Shader::CheckCompileStatus(unsigned int stage, unsigned int id)
+{
     // Error handling
     int result;
     GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result)); // Returns the compile status parameter
@@ -66,69 +265,773 @@ unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
         GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
         char* message = (char*)alloca(length * sizeof(char)); // Allocate this on the stack dynamically because 'char message[length]' is not allowed
         GLCall(glGetShaderInfoLog(id, length, &length, message));
-        std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader:" << std::endl;
+        std::cout << "Failed to compile " << s_StageNames[stage] << " shader:" << std::endl;
         std::cout << message << std::endl;
-        GLCall(glDeleteShader(id));
-        return 0;
+        return false;
     }
 
-    return id;
+    return true;
 }
 
-unsigned int Shader::CreateShader(const std::string& vertexShader, const std::string& fragmentShader)
+unsigned int Shader::CreateShader(const ShaderProgramSource& source)
 {
-    unsigned int program = glCreateProgram(); // Create a shader program to attach shader to
-    unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    // Load the program from a binary of a previous launch if the sources and driver are the same
+    ShaderCache& cache = ShaderCache::Get();
+    m_CacheKey = cache.GetKey(source.Sources, ShaderStageCount);
+
+    unsigned int program = cache.Load(m_CacheKey);
+    if (program)
+        return program;
 
-    // Attach both shaders to the program
-    GLCall(glAttachShader(program, vs));
-    GLCall(glAttachShader(program, fs));
+    m_CompileStart = std::chrono::high_resolution_clock::now();
 
-    GLCall(glLinkProgram(program)); // Link the program so the shaders are used
-    GLCall(glValidateProgram(program)); // Check if the program can be executed
+    program = glCreateProgram(); // Create a shader program to attach shader to
+    for (unsigned int i = 0; i < ShaderStageCount; i++)
+    {
+        if (source.Sources[i].empty())
+            continue;
+
+        m_Stages[i] = CompileShader(s_StageTypes[i], source.Sources[i]);
+        GLCall(glAttachShader(program, m_Stages[i]));
+    }
 
-                                        // The shaders are linked to the progam, so the shaders can be deleted
-    GLCall(glDeleteShader(vs));
-    GLCall(glDeleteShader(fs));
+    cache.PrepareProgram(program);
+    GLCall(glLinkProgram(program)); // Link the program so the shaders are used, the driver may do this in the background
 
+    m_Pending = true;
     return program;
 }
 
+bool Shader::IsLinkComplete() const
+{
+    if (!ShaderCompiler::Get().IsParallel())
+        return true;
+
+    int complete;
+    GLCall(glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &complete));
+    return complete == GL_TRUE;
+}
+
+void Shader::FinishShader()
+{
+    if (m_Pending)
+    {
+        m_Pending = false;
+
+        for (unsigned int i = 0; i < ShaderStageCount; i++)
+        {
+            if (m_Stages[i])
+                CheckCompileStatus(i, m_Stages[i]);
+        }
+
+        int linked;
+        GLCall(glGetProgramiv(m_RendererID, GL_LINK_STATUS, &linked));
+        if (linked == GL_FALSE)
+        {
+            int length;
+            GLCall(glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &length));
+            char* message = (char*)alloca(length * sizeof(char));
+            GLCall(glGetProgramInfoLog(m_RendererID, length, &length, message));
+            std::cout << "Failed to link " << m_FilePath << ":" << std::endl;
+            std::cout << message << std::endl;
+        }
+
+        // The shaders are linked to the progam, so the shaders can be deleted
+        for (unsigned int& stage : m_Stages)
+        {
+            if (stage)
+            {
+                GLCall(glDetachShader(m_RendererID, stage));
+                GLCall(glDeleteShader(stage));
+                stage = 0;
+            }
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        ShaderCache::Get().Store(m_CacheKey, m_RendererID, std::chrono::duration<double, std::milli>(end - m_CompileStart).count());
+    }
+
+    ReflectUniforms();
+    ReflectAttributes();
+    ReflectUniformBlocks();
+    ReflectStorageBlocks();
+
+    // Set the uniforms for real now that the shader knows them
+    for (const PendingUniform& uniform : m_PendingUniforms)
+        SetUniformData(GetUniform(uniform.Name.c_str()), uniform.Data.data(), (unsigned int)uniform.Data.size());
+
+    m_PendingUniforms.clear();
+    m_PendingUniforms.shrink_to_fit();
+}
+
+/**
+Whether a uniform type is a sampler, which is set to the slot of a texture.
+*/
+static bool IsSamplerType(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_1D_ARRAY:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE:
+        case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_RECT:
+        case GL_SAMPLER_2D_RECT_SHADOW:
+        case GL_INT_SAMPLER_1D:
+        case GL_INT_SAMPLER_2D:
+        case GL_INT_SAMPLER_3D:
+        case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY:
+        case GL_INT_SAMPLER_2D_ARRAY:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_INT_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D_RECT:
+        case GL_UNSIGNED_INT_SAMPLER_1D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_3D:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE:
+        case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+The size in bytes of a single value of a uniform type, samplers are set as an int.
+Doubles, images and other types that UploadUniform can't set have a size of 0.
+*/
+static unsigned int GetUniformTypeSize(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_FLOAT:
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_BOOL:               return 4;
+        case GL_FLOAT_VEC2:
+        case GL_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_BOOL_VEC2:          return 8;
+        case GL_FLOAT_VEC3:
+        case GL_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_BOOL_VEC3:          return 12;
+        case GL_FLOAT_VEC4:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT_VEC4:
+        case GL_BOOL_VEC4:
+        case GL_FLOAT_MAT2:         return 16;
+        case GL_FLOAT_MAT2x3:
+        case GL_FLOAT_MAT3x2:       return 24;
+        case GL_FLOAT_MAT2x4:
+        case GL_FLOAT_MAT4x2:       return 32;
+        case GL_FLOAT_MAT3:         return 36;
+        case GL_FLOAT_MAT3x4:
+        case GL_FLOAT_MAT4x3:       return 48;
+        case GL_FLOAT_MAT4:         return 64;
+        default:                    return IsSamplerType(type) ? 4 : 0;
+    }
+}
+
+/**
+Whether an attribute type reads integers, which glVertexAttribPointer can't provide.
+*/
+static bool IsIntegerAttributeType(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_INT:
+        case GL_INT_VEC2:
+        case GL_INT_VEC3:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC4:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+The amount of locations a single attribute of a type takes up, a location per matrix column.
+*/
+static unsigned int GetAttributeLocationCount(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_FLOAT_MAT2:
+        case GL_FLOAT_MAT2x3:
+        case GL_FLOAT_MAT2x4:       return 2;
+        case GL_FLOAT_MAT3:
+        case GL_FLOAT_MAT3x2:
+        case GL_FLOAT_MAT3x4:       return 3;
+        case GL_FLOAT_MAT4:
+        case GL_FLOAT_MAT4x2:
+        case GL_FLOAT_MAT4x3:       return 4;
+        default:                    return 1;
+    }
+}
+
+/**
+The amount of components an attribute of a type reads from each of its locations, the rows of a matrix.
+*/
+static unsigned int GetAttributeComponentCount(unsigned int type)
+{
+    switch (type)
+    {
+        case GL_FLOAT_VEC2:
+        case GL_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_FLOAT_MAT2:
+        case GL_FLOAT_MAT3x2:
+        case GL_FLOAT_MAT4x2:       return 2;
+        case GL_FLOAT_VEC3:
+        case GL_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_FLOAT_MAT3:
+        case GL_FLOAT_MAT2x3:
+        case GL_FLOAT_MAT4x3:       return 3;
+        case GL_FLOAT_VEC4:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT_VEC4:
+        case GL_FLOAT_MAT4:
+        case GL_FLOAT_MAT2x4:
+        case GL_FLOAT_MAT3x4:       return 4;
+        default:                    return 1;
+    }
+}
+
+/**
+Upload the value of a uniform with the glUniform call that fits its type, only types with a size are supported.
+*/
+static void UploadUniform(int location, unsigned int type, int count, const void* data)
+{
+    const float* f = (const float*)data;
+    const int* i = (const int*)data;
+    const unsigned int* u = (const unsigned int*)data;
+
+    switch (type)
+    {
+        case GL_FLOAT:              GLCall(glUniform1fv(location, count, f)); break;
+        case GL_FLOAT_VEC2:         GLCall(glUniform2fv(location, count, f)); break;
+        case GL_FLOAT_VEC3:         GLCall(glUniform3fv(location, count, f)); break;
+        case GL_FLOAT_VEC4:         GLCall(glUniform4fv(location, count, f)); break;
+        case GL_FLOAT_MAT2:         GLCall(glUniformMatrix2fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT3:         GLCall(glUniformMatrix3fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT4:         GLCall(glUniformMatrix4fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT2x3:       GLCall(glUniformMatrix2x3fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT2x4:       GLCall(glUniformMatrix2x4fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT3x2:       GLCall(glUniformMatrix3x2fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT3x4:       GLCall(glUniformMatrix3x4fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT4x2:       GLCall(glUniformMatrix4x2fv(location, count, GL_FALSE, f)); break;
+        case GL_FLOAT_MAT4x3:       GLCall(glUniformMatrix4x3fv(location, count, GL_FALSE, f)); break;
+        case GL_UNSIGNED_INT:       GLCall(glUniform1uiv(location, count, u)); break;
+        case GL_UNSIGNED_INT_VEC2:  GLCall(glUniform2uiv(location, count, u)); break;
+        case GL_UNSIGNED_INT_VEC3:  GLCall(glUniform3uiv(location, count, u)); break;
+        case GL_UNSIGNED_INT_VEC4:  GLCall(glUniform4uiv(location, count, u)); break;
+        case GL_INT_VEC2:
+        case GL_BOOL_VEC2:          GLCall(glUniform2iv(location, count, i)); break;
+        case GL_INT_VEC3:
+        case GL_BOOL_VEC3:          GLCall(glUniform3iv(location, count, i)); break;
+        case GL_INT_VEC4:
+        case GL_BOOL_VEC4:          GLCall(glUniform4iv(location, count, i)); break;
+        default:
+            ASSERT(type == GL_INT || type == GL_BOOL || IsSamplerType(type));
+            GLCall(glUniform1iv(location, count, i));
+            break;
+    }
+}
+
+/**
+Read the value of a uniform from a linked program with the glGetUniform call that fits its type.
+*/
+static void ReadUniform(unsigned int program, int location, unsigned int type, void* data)
+{
+    switch (type)
+    {
+        case GL_FLOAT:
+        case GL_FLOAT_VEC2:
+        case GL_FLOAT_VEC3:
+        case GL_FLOAT_VEC4:
+        case GL_FLOAT_MAT2:
+        case GL_FLOAT_MAT3:
+        case GL_FLOAT_MAT4:
+        case GL_FLOAT_MAT2x3:
+        case GL_FLOAT_MAT2x4:
+        case GL_FLOAT_MAT3x2:
+        case GL_FLOAT_MAT3x4:
+        case GL_FLOAT_MAT4x2:
+        case GL_FLOAT_MAT4x3:       GLCall(glGetUniformfv(program, location, (float*)data)); break;
+        case GL_UNSIGNED_INT:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC4:  GLCall(glGetUniformuiv(program, location, (unsigned int*)data)); break;
+        default:                    GLCall(glGetUniformiv(program, location, (int*)data)); break; // Int, bool and samplers
+    }
+}
+
+void Shader::ReflectUniforms()
+{
+    m_UniformTable.assign(16, { 0, Empty, 0 });
+
+    int uniformCount;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &uniformCount));
+
+    for (int i = 0; i < uniformCount; i++)
+    {
+        char name[128];
+        int length, size;
+        unsigned int type;
+        GLCall(glGetActiveUniform(m_RendererID, i, sizeof(name), &length, &size, &type, name));
+
+        // Members of uniform blocks have no location, they are set through a uniform buffer
+        GLCall(int location = glGetUniformLocation(m_RendererID, name));
+        if (location == -1)
+            continue;
+
+        // Doubles and images can't be set yet, they stay out of the shadow copy and act like missing uniforms
+        if (GetUniformTypeSize(type) == 0)
+        {
+            std::cout << "Warning: uniform " << name << " of " << m_FilePath << " has a type that can't be set (0x" << std::hex << type << std::dec << ")!" << std::endl;
+            InsertUniform(name, -1);
+            continue;
+        }
+
+        int index = (int)m_Uniforms.size();
+        InsertUniform(name, index);
+
+        // Arrays are reported as "name[0]", they can be set by their plain name as well
+        if (length > 3 && std::string(name + length - 3) == "[0]")
+        {
+            name[length - 3] = '\0';
+            InsertUniform(name, index);
+        }
+
+        m_Uniforms.push_back({ name, location, type, (unsigned int)size, IsSamplerType(type) });
+
+        UniformValue value = { (unsigned int)m_UniformData.size(), GetUniformTypeSize(type) * size, false };
+        m_UniformValues.push_back(value);
+        m_UniformData.resize(value.Offset + value.Size, 0);
+
+        // Uniforms with an initializer don't start at zero, so the shadow copy starts with what the program holds
+        unsigned int typeSize = GetUniformTypeSize(type);
+        for (int element = 0; element < size; element++)
+        {
+            int elementLocation = location;
+            if (element > 0)
+            {
+                std::string elementName = std::string(name) + "[" + std::to_string(element) + "]";
+                GLCall(elementLocation = glGetUniformLocation(m_RendererID, elementName.c_str()));
+            }
+
+            if (elementLocation != -1)
+                ReadUniform(m_RendererID, elementLocation, type, &m_UniformData[value.Offset + element * typeSize]);
+        }
+    }
+}
+
+void Shader::ReflectAttributes()
+{
+    int attributeCount;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_ATTRIBUTES, &attributeCount));
+
+    for (int i = 0; i < attributeCount; i++)
+    {
+        char name[128];
+        int length, size;
+        unsigned int type;
+        GLCall(glGetActiveAttrib(m_RendererID, i, sizeof(name), &length, &size, &type, name));
+
+        // Built in inputs like gl_VertexID have no location and need no buffer
+        GLCall(int location = glGetAttribLocation(m_RendererID, name));
+        if (location == -1)
+            continue;
+
+        m_Attributes.push_back({ name, location, type, (unsigned int)size, GetAttributeLocationCount(type) * size });
+    }
+}
+
+void Shader::InsertUniform(const char* name, int index)
+{
+    if ((m_UniformCount + 1) * 2 > m_UniformTable.size())
+    {
+        std::vector<UniformSlot> slots(m_UniformTable.size() * 2, { 0, Empty, 0 });
+        m_UniformTable.swap(slots);
+
+        for (const auto& slot : slots)
+        {
+            if (slot.Index != Empty)
+                PlaceUniform(slot);
+        }
+    }
+
+    m_UniformNames.push_back(name);
+    PlaceUniform({ UniformName::Hash32(name), index, (unsigned int)m_UniformNames.size() - 1 });
+    m_UniformCount++;
+}
+
+void Shader::PlaceUniform(const UniformSlot& slot)
+{
+    unsigned int mask = (unsigned int)m_UniformTable.size() - 1;
+    for (unsigned int i = slot.Hash & mask; ; i = (i + 1) & mask)
+    {
+        if (m_UniformTable[i].Index == Empty)
+        {
+            m_UniformTable[i] = slot;
+            return;
+        }
+    }
+}
+
+void Shader::ReflectUniformBlocks()
+{
+    int blockCount;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount));
+
+    for (int i = 0; i < blockCount; i++)
+    {
+        char name[128];
+        int length, size;
+        GLCall(glGetActiveUniformBlockName(m_RendererID, i, sizeof(name), &length, name));
+        GLCall(glGetActiveUniformBlockiv(m_RendererID, i, GL_UNIFORM_BLOCK_DATA_SIZE, &size));
+
+        unsigned int binding = GetUniformBlockBinding(name);
+        GLCall(glUniformBlockBinding(m_RendererID, i, binding));
+        m_UniformBlocks.push_back({ name, binding, (unsigned int)size });
+    }
+}
+
+const UniformBlock* Shader::GetUniformBlock(const std::string& name) const
+{
+    for (const auto& block : m_UniformBlocks)
+    {
+        if (block.Name == name)
+            return &block;
+    }
+
+    return nullptr;
+}
+
+unsigned int Shader::GetUniformBlockBinding(const std::string& name)
+{
+    static std::unordered_map<std::string, unsigned int> bindings;
+
+    auto it = bindings.find(name);
+    if (it != bindings.end())
+        return it->second;
+
+    unsigned int binding = (unsigned int)bindings.size();
+    bindings[name] = binding;
+    return binding;
+}
+
+void Shader::ReflectStorageBlocks()
+{
+    if (m_Compute)
+    {
+        int size[3];
+        GLCall(glGetProgramiv(m_RendererID, GL_COMPUTE_WORK_GROUP_SIZE, size));
+        m_WorkGroupSize = { (unsigned int)size[0], (unsigned int)size[1], (unsigned int)size[2] };
+    }
+
+    // Without storage buffers no shader can declare a block, and the program interface can't be queried
+    if (!GLEW_VERSION_4_3 && !GLEW_ARB_shader_storage_buffer_object)
+        return;
+
+    int blockCount;
+    GLCall(glGetProgramInterfaceiv(m_RendererID, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &blockCount));
+
+    for (int i = 0; i < blockCount; i++)
+    {
+        char name[128];
+        int length, size;
+        unsigned int property = GL_BUFFER_DATA_SIZE;
+        GLCall(glGetProgramResourceName(m_RendererID, GL_SHADER_STORAGE_BLOCK, i, sizeof(name), &length, name));
+        GLCall(glGetProgramResourceiv(m_RendererID, GL_SHADER_STORAGE_BLOCK, i, 1, &property, 1, nullptr, &size));
+
+        unsigned int binding = GetStorageBlockBinding(name);
+        GLCall(glShaderStorageBlockBinding(m_RendererID, i, binding));
+        m_StorageBlocks.push_back({ name, binding, (unsigned int)size });
+    }
+}
+
+const StorageBlock* Shader::GetStorageBlock(const std::string& name) const
+{
+    for (const auto& block : m_StorageBlocks)
+    {
+        if (block.Name == name)
+            return &block;
+    }
+
+    return nullptr;
+}
+
+unsigned int Shader::GetStorageBlockBinding(const std::string& name)
+{
+    // Storage buffers have their own binding points, separate from the uniform buffers
+    static std::unordered_map<std::string, unsigned int> bindings;
+
+    auto it = bindings.find(name);
+    if (it != bindings.end())
+        return it->second;
+
+    unsigned int binding = (unsigned int)bindings.size();
+    bindings[name] = binding;
+    return binding;
+}
+
 void Shader::Bind() const
 {
-    GLCall(glUseProgram(m_RendererID));
+    if (m_Pending)
+    {
+        if (m_Fallback)
+        {
+            m_Fallback->Bind();
+            return;
+        }
+
+        ShaderCompiler::Get().Finish(*this);
+    }
+
+    GLStateCache::Get().UseProgram(m_RendererID);
+
+    if (!m_DirtyUniforms.empty())
+        FlushUniforms();
 }
 
 void Shader::Unbind() const
 {
-    GLCall(glUseProgram(0));
+    GLStateCache::Get().UseProgram(0);
 }
 
-void Shader::SetUniform1i(const std::string& name, int value)
+void Shader::SetFallback(Shader* fallback)
 {
-    GLCall(glUniform1i(GetUniformLocation(name), value));
+    ASSERT(!fallback || fallback->IsReady());
+    ASSERT(!fallback || !m_Compute); // A dispatch can't be skipped or replaced, it waits for the compile instead
+    m_Fallback = fallback;
 }
 
-void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
+void Shader::SetUniform1i(const UniformName& name, int value)
 {
-    GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
+    SetUniformData(name, &value, sizeof(int));
 }
 
-void Shader::SetUniformMat4f(const std::string& name, glm::mat4& matrix)
+void Shader::SetUniform1f(const UniformName& name, float value)
 {
-    GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]));
+    SetUniformData(name, &value, sizeof(float));
 }
 
-unsigned int Shader::GetUniformLocation(const std::string& name)
+void Shader::SetUniform1iv(const UniformName& name, int count, const int* values)
 {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-        return m_UniformLocationCache[name];
+    SetUniformData(name, values, count * sizeof(int));
+}
+
+void Shader::SetUniform2f(const UniformName& name, float v0, float v1)
+{
+    float values[] = { v0, v1 };
+    SetUniformData(name, values, sizeof(values));
+}
+
+void Shader::SetUniform4f(const UniformName& name, float v0, float v1, float v2, float v3)
+{
+    float values[] = { v0, v1, v2, v3 };
+    SetUniformData(name, values, sizeof(values));
+}
+
+void Shader::SetUniformMat4f(const UniformName& name, glm::mat4& matrix)
+{
+    SetUniformData(name, &matrix[0][0], sizeof(glm::mat4));
+}
+
+void Shader::SetUniform1i(UniformHandle uniform, int value)
+{
+    SetUniformData(uniform, &value, sizeof(int));
+}
+
+void Shader::SetUniform1f(UniformHandle uniform, float value)
+{
+    SetUniformData(uniform, &value, sizeof(float));
+}
+
+void Shader::SetUniform1iv(UniformHandle uniform, int count, const int* values)
+{
+    SetUniformData(uniform, values, count * sizeof(int));
+}
+
+void Shader::SetUniform2f(UniformHandle uniform, float v0, float v1)
+{
+    float values[] = { v0, v1 };
+    SetUniformData(uniform, values, sizeof(values));
+}
+
+void Shader::SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3)
+{
+    float values[] = { v0, v1, v2, v3 };
+    SetUniformData(uniform, values, sizeof(values));
+}
+
+void Shader::SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix)
+{
+    SetUniformData(uniform, &matrix[0][0], sizeof(glm::mat4));
+}
+
+void Shader::SetUniformData(const UniformName& name, const void* data, unsigned int size)
+{
+    if (!m_Pending)
+    {
+        SetUniformData(GetUniform(name), data, size);
+        return;
+    }
+
+    // The fallback is drawn meanwhile, so it gets the values it has a uniform for
+    if (m_Fallback)
+    {
+        int index = m_Fallback->FindUniform(name);
+        if (index >= 0)
+            m_Fallback->SetUniformData(UniformHandle{ index }, data, size);
+    }
+
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (PendingUniform& uniform : m_PendingUniforms)
+    {
+        if (uniform.Hash == name.Hash && uniform.Name == name.Name)
+        {
+            uniform.Data.assign(bytes, bytes + size);
+            return;
+        }
+    }
+
+    m_PendingUniforms.push_back({ name.Hash, name.Name, std::vector<unsigned char>(bytes, bytes + size) });
+}
+
+void Shader::SetUniformData(UniformHandle uniform, const void* data, unsigned int size)
+{
+    if (uniform.Index == -1)
+        return;
+
+    // Like glUniform, values past the end of an array are ignored, the compiler may have trimmed unused elements
+    UniformValue& value = m_UniformValues[uniform.Index];
+    if (size > value.Size)
+        size = value.Size;
+
+    // Setting the value it already has costs a compare instead of a driver call
+    unsigned char* shadow = &m_UniformData[value.Offset];
+    if (std::memcmp(shadow, data, size) == 0)
+        return;
+
+    std::memcpy(shadow, data, size);
+    if (!value.Dirty)
+    {
+        value.Dirty = true;
+        m_DirtyUniforms.push_back(uniform.Index);
+    }
+}
+
+void Shader::FlushUniforms() const
+{
+    for (unsigned int index : m_DirtyUniforms)
+    {
+        const ShaderUniform& uniform = m_Uniforms[index];
+        UniformValue& value = m_UniformValues[index];
+        UploadUniform(uniform.Location, uniform.Type, uniform.Count, &m_UniformData[value.Offset]);
+        value.Dirty = false;
+    }
+
+    m_UniformUploads += (unsigned int)m_DirtyUniforms.size();
+    m_DirtyUniforms.clear();
+}
+
+int Shader::FindUniform(const UniformName& name) const
+{
+    unsigned int mask = (unsigned int)m_UniformTable.size() - 1;
+    for (unsigned int i = name.Hash & mask; ; i = (i + 1) & mask)
+    {
+        const UniformSlot& slot = m_UniformTable[i];
+        if (slot.Index == Empty)
+            return Empty;
+
+        // The hash almost always decides, the name only has to be compared to rule out a collision
+        if (slot.Hash == name.Hash && m_UniformNames[slot.Name] == name.Name)
+            return slot.Index;
+    }
+}
+
+UniformHandle Shader::GetUniform(const UniformName& name)
+{
+    // The uniforms are only known once the program is linked
+    if (m_Pending)
+        ShaderCompiler::Get().Finish(*this);
+
+    // Every active uniform is in the table since linking, only names that don't exist can be missing
+    int index = FindUniform(name);
+    if (index != Empty)
+        return { index };
+
+    // Remember the missing name, so the warning is only shown once
+    std::cout << "Warning: uniform " << name.Name << " doesn't exist!" << std::endl;
+    InsertUniform(name.Name, -1);
+    return { -1 };
+}
+
+bool Shader::ValidateVertexArray(const VertexArray& va) const
+{
+    // The attributes are only known once the program is linked, until then the fallback is drawn
+    if (m_Pending)
+        return m_Fallback ? m_Fallback->ValidateVertexArray(va) : true;
+
+    if (std::find(m_ValidatedLayouts.begin(), m_ValidatedLayouts.end(), va.GetLayoutID()) != m_ValidatedLayouts.end())
+        return true;
+
+    const std::vector<VertexAttribute>& buffers = va.GetAttributes();
+    bool valid = true;
+
+    for (const ShaderAttribute& attribute : m_Attributes)
+    {
+        for (unsigned int location = attribute.Location; location < attribute.Location + attribute.LocationCount; location++)
+        {
+            if (location >= buffers.size())
+            {
+                std::cout << "Warning: attribute " << attribute.Name << " of " << m_FilePath << " reads location " << location << ", which has no buffer!" << std::endl;
+                valid = false;
+            }
+            else if (IsIntegerAttributeType(attribute.Type))
+            {
+                // The vertex array converts every attribute to floats, whatever the type in the buffer is
+                std::cout << "Warning: attribute " << attribute.Name << " of " << m_FilePath << " is an integer, but location " << location
+                    << " is converted from type 0x" << std::hex << buffers[location].Type << std::dec << " to floats!" << std::endl;
+                valid = false;
+            }
+            else if (buffers[location].Count > GetAttributeComponentCount(attribute.Type))
+            {
+                // Legal, the extra components are ignored, but often a sign of a layout that doesn't match.
+                // Fewer components are fine too, the missing ones are filled in with 0 and a w of 1.
+                std::cout << "Warning: attribute " << attribute.Name << " of " << m_FilePath << " reads " << GetAttributeComponentCount(attribute.Type)
+                    << " components from location " << location << ", but the buffer has " << buffers[location].Count << std::endl;
+            }
+        }
+    }
+
+    if (valid)
+        m_ValidatedLayouts.push_back(va.GetLayoutID());
 
-    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1)
-        std::cout << "Warning: uniform " << name << " doesn't exist!" << std::endl;
-    
-    m_UniformLocationCache[name] = location;
-    return location;
+    return valid;
 }
@@ -1,17 +1,109 @@
 #pragma once
 
+#include <chrono>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #include "glm/glm.hpp"
 
+class VertexArray;
+
+/**
+The stages a shader file can contain, each starts at a "#shader vertex|fragment|geometry|compute" line.
+*/
+enum class ShaderStage
+{
+    Vertex = 0, Fragment = 1, Geometry = 2, Compute = 3
+};
+
+constexpr unsigned int ShaderStageCount = 4;
+
 /**
-A struct that combines shader sources into a single type.
+A struct that combines shader sources into a single type, a stage the file doesn't contain has an empty source.
 */
 struct ShaderProgramSource
 {
-    std::string VertexSource;
-    std::string FragmentSource;
+    std::string_view Sources[ShaderStageCount];
+
+    inline std::string_view Get(ShaderStage stage) const { return Sources[(int)stage]; }
+};
+
+/**
+The name of a uniform together with its FNV-1a hash. A constexpr UniformName is hashed at compile time,
+so setting a uniform with it is a lookup in a flat table without allocating or hashing a string.
+*/
+struct UniformName
+{
+    unsigned int Hash;
+    const char* Name;
+
+    constexpr UniformName(const char* name)
+        : Hash(Hash32(name)), Name(name) {}
+
+    static constexpr unsigned int Hash32(const char* name)
+    {
+        unsigned int hash = 2166136261u;
+        while (*name)
+        {
+            hash ^= (unsigned char)*name++;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+/**
+The index of a uniform in the reflection table of a shader, returned by Shader::GetUniform.
+Setting a uniform with a handle skips the name lookup entirely.
+*/
+struct UniformHandle
+{
+    int Index; // -1 when the shader has no uniform with this name
+};
+
+/**
+An active uniform that was found in a shader after linking, members of uniform blocks are not included.
+*/
+struct ShaderUniform
+{
+    std::string Name; // Without the [0] of arrays
+    int Location;
+    unsigned int Type;
+    unsigned int Count; // The amount of array elements, 1 when it's not an array
+    bool Sampler;
+};
+
+/**
+An active vertex attribute that was found in a shader after linking.
+*/
+struct ShaderAttribute
+{
+    std::string Name;
+    int Location;
+    unsigned int Type;
+    unsigned int Count; // The amount of array elements
+    unsigned int LocationCount; // The amount of locations taken up, a mat4 takes up 4
+};
+
+/**
+A uniform block that was found in a shader after linking.
+*/
+struct UniformBlock
+{
+    std::string Name;
+    unsigned int Binding; // The binding point, the same for every shader with a block of this name
+    unsigned int Size; // The size in bytes, including the std140 padding
+};
+
+/**
+A shader storage block that was found in a shader after linking.
+*/
+struct StorageBlock
+{
+    std::string Name;
+    unsigned int Binding; // The binding point, the same for every shader with a block of this name
+    unsigned int Size; // The size in bytes of the fixed part, an unsized array at the end adds nothing
 };
 
 class Shader
@@ -19,51 +111,290 @@ class Shader
 private:
     std::string m_FilePath;
     unsigned int m_RendererID;
-    std::unordered_map<std::string, int> m_UniformLocationCache;
+
+    /**
+        A slot of the uniform table, the table is open addressed with linear probing and has a power of two size.
+    */
+    struct UniformSlot
+    {
+        unsigned int Hash;
+        int Index; // Empty for a free slot, -1 for a name that doesn't exist in the shader
+        unsigned int Name; // The index of the name in m_UniformNames, two names can have the same hash
+    };
+    static const int Empty = -2;
+
+    /**
+        The place of the value of a uniform in the shadow copy, at the same index as the uniform.
+    */
+    struct UniformValue
+    {
+        unsigned int Offset;
+        unsigned int Size;
+        bool Dirty;
+    };
+
+    // What the program contains, collected once after linking
+    std::vector<ShaderUniform> m_Uniforms;
+    std::vector<ShaderAttribute> m_Attributes;
+    std::vector<UniformBlock> m_UniformBlocks;
+    std::vector<StorageBlock> m_StorageBlocks;
+    bool m_Compute;
+    glm::uvec3 m_WorkGroupSize;
+
+    std::vector<UniformSlot> m_UniformTable;
+    std::vector<std::string> m_UniformNames;
+    unsigned int m_UniformCount;
+
+    // The values of all uniforms as they were last set, changed values are uploaded when the shader is bound
+    mutable std::vector<UniformValue> m_UniformValues;
+    std::vector<unsigned char> m_UniformData;
+    mutable std::vector<unsigned int> m_DirtyUniforms;
+    mutable unsigned int m_UniformUploads;
+
+    mutable std::vector<unsigned int> m_ValidatedLayouts; // The layout IDs of the vertex arrays that passed
+
+    // Set while the program compiles in the background, the fallback is drawn in its place
+    bool m_Pending;
+    unsigned int m_Stages[ShaderStageCount];
+    unsigned long long m_CacheKey;
+    std::chrono::high_resolution_clock::time_point m_CompileStart;
+    Shader* m_Fallback;
+
+    /**
+        A uniform that was set while compiling, it's set for real once the uniforms are known.
+    */
+    struct PendingUniform
+    {
+        unsigned int Hash;
+        std::string Name;
+        std::vector<unsigned char> Data;
+    };
+    std::vector<PendingUniform> m_PendingUniforms;
 public:
-    Shader(const std::string& filePath);
+    /**
+        Load a shader from a file.
+
+        @param filePath Path to the shader file
+        @param async Return before the program is compiled, ShaderCompiler::Update finishes it once the driver is done
+    */
+    Shader(const std::string& filePath, bool async = false);
+
+    /**
+        Load a variant of a shader, the defines are added to every stage right after its #version line, or at the top of a stage without one.
+
+        @param filePath Path to the shader file
+        @param defines The defines of the variant, a name or a name and a value like "MAX_LIGHTS 4"
+        @param async Return before the program is compiled, ShaderCompiler::Update finishes it once the driver is done
+    */
+    Shader(const std::string& filePath, const std::vector<std::string>& defines, bool async = false);
     ~Shader();
 
+    /**
+        Use the shader and upload the uniforms that changed since it was bound last time.
+        While the shader compiles its fallback is used instead, without a fallback this waits for the compile.
+    */
     void Bind() const;
     void Unbind() const;
 
-    // Set uniforms
-    void SetUniform1i(const std::string& name, int value);
-    void SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
-    void SetUniformMat4f(const std::string& name, glm::mat4& matrix);
-private:
+    /**
+        Set the shader that is drawn while this shader compiles, it receives the uniforms that both shaders have.
+
+        @param fallback A shader that is ready, usually a cheap one with the same attributes
+    */
+    void SetFallback(Shader* fallback);
 
     /**
-        Parse a single shader file to a shader source.
+        Whether the shader finished compiling, the reflected uniforms, attributes and blocks are empty until then.
+    */
+    inline bool IsReady() const { return !m_Pending; }
 
-        @param filePath Path to the shader file
-        @return ShaderProgramSource The combined shader sources in as ShaderProgramSource
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline unsigned int GetUniformUploads() const { return m_UniformUploads; }
+    inline const std::vector<ShaderUniform>& GetUniforms() const { return m_Uniforms; }
+    inline const std::vector<ShaderAttribute>& GetAttributes() const { return m_Attributes; }
+    inline const std::vector<UniformBlock>& GetUniformBlocks() const { return m_UniformBlocks; }
+    inline const std::vector<StorageBlock>& GetStorageBlocks() const { return m_StorageBlocks; }
+
+    /**
+        Whether the file has a compute stage, the shader is then run with Renderer::Dispatch instead of drawn.
     */
-    ShaderProgramSource ParseShader(const std::string filePath);
+    inline bool IsCompute() const { return m_Compute; }
 
     /**
-        Links the given shaders into a single shader so that it can be bound.
+        The local size of a compute shader, zero until the shader is ready or when it has no compute stage.
+        Divide the amount of work by it to find the amount of work groups to dispatch.
+    */
+    inline const glm::uvec3& GetWorkGroupSize() const { return m_WorkGroupSize; }
+
+    /**
+        Find a uniform of this shader, look it up once and keep the handle to set it without a lookup.
+        This waits for the shader to finish compiling.
+
+        @param name The name of the uniform
+        @return The handle, its index is -1 when the shader has no uniform with this name
+    */
+    UniformHandle GetUniform(const UniformName& name);
+
+    /**
+        Check that a vertex array feeds every attribute of this shader with floats, the problems are printed to the
+        console. Locations with more components than the attribute reads only print a warning. A layout that passed
+        is remembered, so checking it before every draw is cheap.
+
+        @param va The vertex array to draw with
+        @return Whether the vertex array can be drawn with this shader
+    */
+    bool ValidateVertexArray(const VertexArray& va) const;
+
+    /**
+        Find a uniform block of this shader.
+
+        @param name The name of the block
+        @return The block, or nullptr when the shader has no block with this name
+    */
+    const UniformBlock* GetUniformBlock(const std::string& name) const;
+
+    /**
+        Return the binding point of a uniform block name, every name gets its own binding point the first time it's asked for.
+        Shaders and uniform buffers both use this, so a buffer is read by every shader that declares its block.
+    */
+    static unsigned int GetUniformBlockBinding(const std::string& name);
+
+    /**
+        Find a shader storage block of this shader.
 
-        @param vertexShader Source of the vertexshader as string
-        @param fragmentShader Source of the fragmentshader as string
+        @param name The name of the block
+        @return The block, or nullptr when the shader has no block with this name
+    */
+    const StorageBlock* GetStorageBlock(const std::string& name) const;
+
+    /**
+        Return the binding point of a storage block name, like GetUniformBlockBinding but for shader storage buffers.
+    */
+    static unsigned int GetStorageBlockBinding(const std::string& name);
+
+    /**
+        Split a shader file into its stages in a single pass, the sources are views into the file.
+        Text before the first #shader line and stages with an unknown name are skipped.
+
+        @param file The contents of the shader file
+        @return ShaderProgramSource The sources of the stages
+    */
+    static ShaderProgramSource ParseShader(std::string_view file);
+
+    // Set uniforms, the name can be a string literal or a constexpr UniformName to hash it at compile time.
+    // The values are uploaded on the next Bind, and only if they differ from the previous values.
+    void SetUniform1i(const UniformName& name, int value);
+    void SetUniform1f(const UniformName& name, float value);
+    void SetUniform1iv(const UniformName& name, int count, const int* values);
+    void SetUniform2f(const UniformName& name, float v0, float v1);
+    void SetUniform4f(const UniformName& name, float v0, float v1, float v2, float v3);
+    void SetUniformMat4f(const UniformName& name, glm::mat4& matrix);
+
+    // Set uniforms by a handle from GetUniform
+    void SetUniform1i(UniformHandle uniform, int value);
+    void SetUniform1f(UniformHandle uniform, float value);
+    void SetUniform1iv(UniformHandle uniform, int count, const int* values);
+    void SetUniform2f(UniformHandle uniform, float v0, float v1);
+    void SetUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3);
+    void SetUniformMat4f(UniformHandle uniform, const glm::mat4& matrix);
+private:
+    friend class ShaderCompiler;
+
+    /**
+        Links the given shaders into a single shader so that it can be bound. A program from the shader cache is
+        ready right away, otherwise the shader is pending until FinishShader checked the result.
+
+        @param source The sources of the stages, only the stages with a source are compiled
         @return unsigned int An identifier for the newly created shader
     */
-    unsigned int CreateShader(const std::string& vertexShader, const std::string& fragmentShader);
+    unsigned int CreateShader(const ShaderProgramSource& source);
 
     /**
-        Compiles a single shader so it can be attached.
+        Compiles a single shader so it can be attached, the status is only checked by FinishShader.
 
         @param type The type of the shader
-        @param source The source code of the shader as string
+        @param source The source code of the shader
         @return unsigned int An identifier for the compiled shader
     */
-    unsigned int CompileShader(unsigned int type, const std::string& source);
+    unsigned int CompileShader(unsigned int type, std::string_view source);
 
     /**
-        Return the location of the shader based on uniform name
+        Print the log of a shader stage when it failed to compile.
 
-        @param name The name of the uniform
-        @return The location
+        @param stage The index of the stage
+        @param id The compiled shader
+        @return Whether the stage compiled
+    */
+    bool CheckCompileStatus(unsigned int stage, unsigned int id);
+
+    /**
+        Whether the driver finished linking, always true without GL_KHR_parallel_shader_compile.
+    */
+    bool IsLinkComplete() const;
+
+    /**
+        Check the compile results, store the program in the shader cache and collect its uniforms, which waits for
+        the driver when it isn't done yet. The uniforms that were set while compiling are set afterwards.
+    */
+    void FinishShader();
+
+    /**
+        Collect all active uniforms of the linked program into the uniform table and make room for their values.
+    */
+    void ReflectUniforms();
+
+    /**
+        Collect all active vertex attributes of the linked program.
+    */
+    void ReflectAttributes();
+
+    /**
+        Add a name to the uniform table, the table doubles in size when it's half full.
+
+        @param name The name, it's compared when a lookup finds its hash
+        @param index The index of the uniform, -1 for a name that doesn't exist in the shader
+    */
+    void InsertUniform(const char* name, int index);
+
+    /**
+        Put a slot in the first free place after the place its hash points at.
+    */
+    void PlaceUniform(const UniformSlot& slot);
+
+    /**
+        Find a uniform in the uniform table without a warning when it's missing.
+
+        @return The index of the uniform, -1 for a name that was missing before and Empty for an unknown name
+    */
+    int FindUniform(const UniformName& name) const;
+
+    /**
+        Set a uniform by name, or remember the value for later while the shader compiles.
+    */
+    void SetUniformData(const UniformName& name, const void* data, unsigned int size);
+
+    /**
+        Copy a value into the shadow copy and mark the uniform dirty when the value changed.
+
+        @param uniform The uniform, nothing happens when its index is -1
+        @param data The value, an array of values for array uniforms
+        @param size The size of the value in bytes
+    */
+    void SetUniformData(UniformHandle uniform, const void* data, unsigned int size);
+
+    /**
+        Upload the dirty uniforms, the shader must be in use.
+    */
+    void FlushUniforms() const;
+
+    /**
+        Find the uniform blocks of the linked program and bind each of them to the binding point of its name.
+    */
+    void ReflectUniformBlocks();
+
+    /**
+        Find the storage blocks of the linked program and bind each of them to the binding point of its name,
+        and read the work group size of a compute shader.
     */
-    unsigned int GetUniformLocation(const std::string& name);
+    void ReflectStorageBlocks();
 };
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "ShaderCache.h"
+#include "Renderer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+/**
+The start of every binary file, the format and length are what glProgramBinary needs.
+*/
+struct ProgramBinaryHeader
+{
+    unsigned int Magic;
+    unsigned int Format;
+    unsigned int Length;
+    double CompileTime;
+};
+
+static const unsigned int ProgramBinaryMagic = 0x31424750; // "PGB1"
+
+/**
+FNV-1a over a block of bytes, continuing from a previous hash.
+*/
+static unsigned long long Hash64(const void* data, size_t size, unsigned long long hash = 14695981039346656037ull)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static unsigned long long HashString(const char* string, unsigned long long hash)
+{
+    return string ? Hash64(string, std::strlen(string), hash) : hash;
+}
+
+static double GetElapsedTime(std::chrono::high_resolution_clock::time_point start)
+{
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+ShaderCache::ShaderCache()
+    : m_DriverHash(0), m_Supported(false), m_Enabled(true)
+{
+    m_DriverHash = HashString((const char*)glGetString(GL_VENDOR), Hash64(nullptr, 0));
+    m_DriverHash = HashString((const char*)glGetString(GL_RENDERER), m_DriverHash);
+    m_DriverHash = HashString((const char*)glGetString(GL_VERSION), m_DriverHash);
+
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary)
+    {
+        int formatCount;
+        GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+        m_Supported = formatCount > 0;
+    }
+
+    SetDirectory("res/shadercache");
+}
+
+ShaderCache& ShaderCache::Get()
+{
+    static ShaderCache cache;
+    return cache;
+}
+
+unsigned long long ShaderCache::GetKey(const std::string_view* sources, unsigned int count) const
+{
+    unsigned long long key = m_DriverHash;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        // The length keeps moving text between stages from giving the same key
+        unsigned int length = (unsigned int)sources[i].size();
+        key = Hash64(&length, sizeof(length), key);
+        key = Hash64(sources[i].data(), sources[i].size(), key);
+    }
+    return key;
+}
+
+unsigned int ShaderCache::Load(unsigned long long key)
+{
+    if (!m_Supported || !m_Enabled)
+    {
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::ifstream file(GetPath(key), std::ios::binary);
+    ProgramBinaryHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || header.Magic != ProgramBinaryMagic)
+    {
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    std::vector<char> binary(header.Length);
+    if (!file.read(binary.data(), header.Length))
+    {
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    // A format the driver doesn't know would be an error, rather than a failed link
+    int formatCount;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+    std::vector<int> formats(formatCount);
+    GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    if (std::find(formats.begin(), formats.end(), (int)header.Format) == formats.end())
+    {
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    GLCall(glProgramBinary(program, header.Format, binary.data(), header.Length));
+
+    // The driver may still reject the binary, the program is compiled from source then
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE)
+    {
+        GLCall(glDeleteProgram(program));
+        m_Stats.Misses++;
+        return 0;
+    }
+
+    double loadTime = GetElapsedTime(start);
+    m_Stats.Hits++;
+    m_Stats.LoadTime += loadTime;
+    m_Stats.TimeSaved += header.CompileTime - loadTime;
+    return program;
+}
+
+void ShaderCache::PrepareProgram(unsigned int program) const
+{
+    if (m_Supported && m_Enabled)
+    {
+        GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+    }
+}
+
+void ShaderCache::Store(unsigned long long key, unsigned int program, double compileTime)
+{
+    m_Stats.CompileTime += compileTime;
+
+    if (!m_Supported || !m_Enabled)
+        return;
+
+    int linked, length;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (linked == GL_FALSE || length == 0)
+        return;
+
+    ProgramBinaryHeader header;
+    header.Magic = ProgramBinaryMagic;
+    header.CompileTime = compileTime;
+
+    std::vector<char> binary(length);
+    GLCall(glGetProgramBinary(program, length, &length, &header.Format, binary.data()));
+    header.Length = (unsigned int)length;
+
+    std::ofstream file(GetPath(key), std::ios::binary);
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), length);
+}
+
+void ShaderCache::SetDirectory(const std::string& directory)
+{
+    m_Directory = directory;
+
+    // Fails harmlessly when the directory already exists
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+}
+
+std::string ShaderCache::GetPath(unsigned long long key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", key);
+    return m_Directory + "/" + name;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+Hits are programs that were loaded from a binary, misses had to be compiled from source.
+The time saved is the compile time stored with each binary minus the time it took to load it.
+*/
+struct ShaderCacheStats
+{
+    unsigned int Hits = 0;
+    unsigned int Misses = 0;
+    double LoadTime = 0.0; // Milliseconds spent loading binaries
+    double CompileTime = 0.0; // Milliseconds spent compiling and linking the misses
+    double TimeSaved = 0.0;
+};
+
+/**
+Stores linked programs on disk with glGetProgramBinary and loads them with glProgramBinary on the next launch.
+A binary is keyed by a hash of the sources together with the vendor, renderer and version of the driver,
+so a driver update or a changed source compiles again. Without OpenGL 4.1 or ARB_get_program_binary, or when
+the driver supports no binary formats, every program is compiled.
+*/
+class ShaderCache
+{
+private:
+    std::string m_Directory;
+    unsigned long long m_DriverHash;
+    bool m_Supported;
+    bool m_Enabled;
+    ShaderCacheStats m_Stats;
+public:
+    ShaderCache();
+
+    /**
+        Return the shader cache, the binaries only fit the driver of the context that is current on the first call.
+    */
+    static ShaderCache& Get();
+
+    /**
+        Compute the key of a program.
+
+        @param sources The sources of all stages of the program after preprocessing, empty for missing stages
+        @param count The amount of sources
+        @return The key, which includes the driver
+    */
+    unsigned long long GetKey(const std::string_view* sources, unsigned int count) const;
+
+    /**
+        Create a program from a stored binary.
+
+        @param key The key from GetKey
+        @return The linked program, or 0 when there is no usable binary and the program has to be compiled
+    */
+    unsigned int Load(unsigned long long key);
+
+    /**
+        Prepare a program that will be stored, call before glLinkProgram so the driver keeps its binary.
+    */
+    void PrepareProgram(unsigned int program) const;
+
+    /**
+        Store the binary of a compiled and linked program.
+
+        @param key The key from GetKey
+        @param program The program, nothing is stored when it failed to link
+        @param compileTime The milliseconds it took to compile and link, a later hit saves this time
+    */
+    void Store(unsigned long long key, unsigned int program, double compileTime);
+
+    /**
+        Change the directory of the binaries, it's created when it doesn't exist yet.
+    */
+    void SetDirectory(const std::string& directory);
+
+    /**
+        Turn the cache off to always compile, for example to measure the compiler.
+    */
+    inline void SetEnabled(bool enabled) { m_Enabled = enabled; }
+
+    inline bool IsSupported() const { return m_Supported; }
+    inline const ShaderCacheStats& GetStats() const { return m_Stats; }
+private:
+    std::string GetPath(unsigned long long key) const;
+};
\ No newline at end of file
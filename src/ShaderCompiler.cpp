@@ -0,0 +1,76 @@
+#include "ShaderCompiler.h"
+#include "Renderer.h"
+
+#include <algorithm>
+
+ShaderCompiler::ShaderCompiler()
+    : m_Parallel(GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile)
+{
+    // The maximum tells the driver to pick the amount of threads itself
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+    }
+}
+
+ShaderCompiler& ShaderCompiler::Get()
+{
+    static ShaderCompiler compiler;
+    return compiler;
+}
+
+unsigned int ShaderCompiler::Update()
+{
+    for (unsigned int i = 0; i < m_Pending.size(); )
+    {
+        Shader* shader = m_Pending[i];
+        if (m_Parallel && !shader->IsLinkComplete())
+        {
+            i++;
+            continue;
+        }
+
+        m_Pending.erase(m_Pending.begin() + i);
+        shader->FinishShader();
+
+        if (!m_Parallel)
+            break;
+    }
+
+    return (unsigned int)m_Pending.size();
+}
+
+void ShaderCompiler::Finish(const Shader& shader)
+{
+    auto it = std::find(m_Pending.begin(), m_Pending.end(), &shader);
+    if (it == m_Pending.end())
+        return;
+
+    Shader* pending = *it;
+    m_Pending.erase(it);
+    pending->FinishShader();
+}
+
+void ShaderCompiler::FinishAll()
+{
+    // Finish in submission order, the driver most likely compiled them in that order too
+    std::vector<Shader*> pending;
+    pending.swap(m_Pending);
+
+    for (Shader* shader : pending)
+        shader->FinishShader();
+}
+
+void ShaderCompiler::Add(Shader& shader)
+{
+    m_Pending.push_back(&shader);
+}
+
+void ShaderCompiler::Remove(const Shader& shader)
+{
+    m_Pending.erase(std::remove(m_Pending.begin(), m_Pending.end(), &shader), m_Pending.end());
+}
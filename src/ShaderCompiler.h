@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+
+class Shader;
+
+/**
+Keeps track of the shaders that are compiling in the background. With GL_KHR_parallel_shader_compile the driver
+compiles on its own threads and Update finishes every program that completed. Without it the status queries
+would block, so Update finishes a single program per call to spread the stalls over the frames.
+*/
+class ShaderCompiler
+{
+private:
+    std::vector<Shader*> m_Pending;
+    bool m_Parallel;
+public:
+    ShaderCompiler();
+
+    /**
+        Return the compiler of the context, the first call lets the driver use as many compiler threads as it likes.
+    */
+    static ShaderCompiler& Get();
+
+    /**
+        Finish the programs that completed, call once per frame.
+
+        @return The amount of programs that are still compiling
+    */
+    unsigned int Update();
+
+    /**
+        Wait for a shader, it can be used with all of its uniforms afterwards.
+    */
+    void Finish(const Shader& shader);
+
+    /**
+        Wait for all shaders, for example at the end of a loading screen.
+    */
+    void FinishAll();
+
+    inline bool IsParallel() const { return m_Parallel; }
+    inline unsigned int GetPendingCount() const { return (unsigned int)m_Pending.size(); }
+private:
+    friend class Shader;
+
+    void Add(Shader& shader);
+    void Remove(const Shader& shader);
+};
\ No newline at end of file
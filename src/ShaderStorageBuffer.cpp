@@ -0,0 +1,29 @@
+#include "ShaderStorageBuffer.h"
+#include "Renderer.h"
+
+ShaderStorageBuffer::ShaderStorageBuffer(const std::string& blockName, unsigned int size, const void* data)
+    : m_Binding(Shader::GetStorageBlockBinding(blockName)), m_Size(size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_COPY)); // Written and read by the GPU
+}
+
+ShaderStorageBuffer::~ShaderStorageBuffer()
+{
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void ShaderStorageBuffer::SetData(unsigned int offset, const void* data, unsigned int size)
+{
+    ASSERT(offset + size <= m_Size);
+
+    GLStateCache::Get().BindBuffer(GL_SHADER_STORAGE_BUFFER, m_RendererID);
+    GLCall(glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data));
+}
+
+void ShaderStorageBuffer::Bind() const
+{
+    GLStateCache::Get().BindBufferBase(GL_SHADER_STORAGE_BUFFER, m_Binding, m_RendererID);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+
+/**
+A buffer that shaders read and write through a storage block, shared by every shader that declares a block
+with the same name. Compute shaders fill it on the GPU, and it can be drawn from like a vertex buffer, so the
+data never has to pass through the CPU. Needs OpenGL 4.3 or ARB_shader_storage_buffer_object.
+*/
+class ShaderStorageBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Binding;
+    unsigned int m_Size;
+public:
+    /**
+        Create the buffer for a storage block.
+
+        @param blockName The name of the block in the shaders, decides the binding point
+        @param size The size of the buffer in bytes
+        @param data The initial contents, or nullptr to leave them undefined
+    */
+    ShaderStorageBuffer(const std::string& blockName, unsigned int size, const void* data = nullptr);
+    ~ShaderStorageBuffer();
+
+    /**
+        Overwrite a part of the buffer from the CPU, the data must follow the std430 layout of the block.
+    */
+    void SetData(unsigned int offset, const void* data, unsigned int size);
+
+    /**
+        Bind the buffer to the binding point of its block.
+    */
+    void Bind() const;
+
+    inline unsigned int GetBinding() const { return m_Binding; }
+    inline unsigned int GetSize() const { return m_Size; }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+};
\ No newline at end of file
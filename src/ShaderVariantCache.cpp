@@ -0,0 +1,28 @@
+#include "ShaderVariantCache.h"
+
+#include <algorithm>
+
+ShaderVariantCache::ShaderVariantCache()
+    : m_Compiles(0)
+{
+}
+
+Shader& ShaderVariantCache::Get(const std::string& filePath, std::vector<std::string> defines, bool async)
+{
+    // The same set of defines in another order is the same variant
+    std::sort(defines.begin(), defines.end());
+    defines.erase(std::unique(defines.begin(), defines.end()), defines.end());
+
+    std::string key = filePath;
+    for (const std::string& define : defines)
+        key += '\n' + define;
+
+    std::unique_ptr<Shader>& variant = m_Variants[key];
+    if (!variant)
+    {
+        variant = std::make_unique<Shader>(filePath, defines, async);
+        m_Compiles++;
+    }
+
+    return *variant;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+
+/**
+Compiles the variants of shaders on demand and keeps them, a variant is a shader file with a set of defines.
+Features are switched with #ifdef in the shader, so every variant only contains the code it needs and the
+shader doesn't branch on uniforms at runtime. Looking up a variant builds its key, keep the reference for
+shaders that are used every frame.
+*/
+class ShaderVariantCache
+{
+private:
+    std::unordered_map<std::string, std::unique_ptr<Shader>> m_Variants;
+    unsigned int m_Compiles;
+public:
+    ShaderVariantCache();
+
+    /**
+        Return a variant of a shader, it's compiled the first time it's asked for.
+
+        @param filePath Path to the shader file
+        @param defines The defines of the variant, their order doesn't matter
+        @param async Compile the variant in the background, see ShaderCompiler
+        @return The variant, it stays valid until the cache is cleared
+    */
+    Shader& Get(const std::string& filePath, std::vector<std::string> defines = {}, bool async = false);
+
+    /**
+        Delete all variants.
+    */
+    inline void Clear() { m_Variants.clear(); }
+
+    inline unsigned int GetCount() const { return (unsigned int)m_Variants.size(); }
+    inline unsigned int GetCompileCount() const { return m_Compiles; }
+};
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "StreamBuffer.h"
+#include "Renderer.h"
+
+StreamBuffer::StreamBuffer(unsigned int regionSize, unsigned int regionCount)
+    : m_RegionSize(regionSize), m_RegionCount(regionCount), m_Persistent(GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage),
+      m_Mapped(nullptr), m_Fences(regionCount, nullptr), m_Region(0), m_Offset(0), m_MapOffset(0), m_IsMapped(false)
+{
+    ASSERT(regionCount > 0);
+
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+
+    unsigned int size = regionSize * regionCount;
+
+    if (m_Persistent)
+    {
+        // Immutable storage that stays mapped for the lifetime of the buffer, coherent so writes need no flush
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+        GLCall(m_Mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    }
+    else
+    {
+        GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+    }
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (GLsync fence : m_Fences)
+    {
+        if (fence)
+        {
+            GLCall(glDeleteSync(fence));
+        }
+    }
+
+    if (m_Persistent || m_IsMapped)
+    {
+        GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+        GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+    }
+
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void* StreamBuffer::Map(unsigned int size, unsigned int stride)
+{
+    ASSERT(!m_IsMapped && size <= m_RegionSize);
+
+    // Start at a whole vertex, so the vertices can be drawn with a base vertex
+    unsigned int offset = (m_Offset + stride - 1) / stride * stride;
+
+    if (m_Persistent)
+    {
+        unsigned int regionEnd = (m_Region + 1) * m_RegionSize;
+
+        if (offset + size > regionEnd)
+        {
+            // Everything in the current region has been drawn, the fence signals when the GPU is done with it
+            GLCall(m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+            m_Region = (m_Region + 1) % m_RegionCount;
+            WaitForRegion(m_Region);
+
+            offset = (m_Region * m_RegionSize + stride - 1) / stride * stride;
+            ASSERT(offset + size <= (m_Region + 1) * m_RegionSize);
+            m_Stats.Wraps++;
+        }
+
+        m_MapOffset = offset;
+        m_IsMapped = true;
+        return m_Mapped + offset;
+    }
+
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+
+    if (offset + size > m_RegionSize * m_RegionCount)
+    {
+        // Orphan the full storage, the driver keeps the old one alive until the GPU is done with it
+        GLCall(glBufferData(GL_ARRAY_BUFFER, m_RegionSize * m_RegionCount, nullptr, GL_STREAM_DRAW));
+        offset = 0;
+        m_Stats.Wraps++;
+    }
+
+    // Nothing the GPU may still read is in this range, so there's no need to synchronize
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+    GLCall(m_Mapped = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, offset, size, flags));
+
+    m_MapOffset = offset;
+    m_IsMapped = true;
+    return m_Mapped;
+}
+
+unsigned int StreamBuffer::Unmap(unsigned int size, unsigned int stride)
+{
+    ASSERT(m_IsMapped);
+
+    if (!m_Persistent)
+    {
+        GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+        if (size > 0)
+        {
+            GLCall(glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, size)); // Relative to the start of the mapped range
+        }
+        GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+        m_Mapped = nullptr;
+    }
+
+    m_Offset = m_MapOffset + size;
+    m_IsMapped = false;
+    m_Stats.Bytes += size;
+    return m_MapOffset / stride;
+}
+
+void StreamBuffer::WaitForRegion(unsigned int region)
+{
+    GLsync& fence = m_Fences[region];
+    if (!fence)
+        return;
+
+    // Only flush the commands when the GPU isn't done yet, a signaled fence costs nothing
+    GLenum result;
+    GLCall(result = glClientWaitSync(fence, 0, 0));
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        m_Stats.Stalls++;
+        do
+        {
+            GLCall(result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000)); // 1 ms
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+
+    GLCall(glDeleteSync(fence));
+    fence = nullptr;
+}
+
+void StreamBuffer::Bind() const
+{
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void StreamBuffer::Unbind() const
+{
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
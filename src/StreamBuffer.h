@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+
+/**
+Statistics about a stream buffer since the last reset.
+*/
+struct StreamBufferStats
+{
+    unsigned int Bytes = 0; // Bytes handed out by Unmap
+    unsigned int Wraps = 0; // Times the buffer moved to the next region, or orphaned its storage
+    unsigned int Stalls = 0; // Times the CPU had to wait for the GPU to release a region
+};
+
+/**
+A buffer for data that changes every frame, like streamed vertices or per draw uniforms, the CPU writes straight into buffer memory.
+With glBufferStorage the buffer stays mapped and is split in regions, every region gets a fence when
+the buffer moves on to the next one, so a region is only written to again once the GPU is done with it.
+Without glBufferStorage (OpenGL 3.3) ranges are mapped unsynchronized and the storage is orphaned when it is full.
+*/
+class StreamBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_RegionSize;
+    unsigned int m_RegionCount;
+    bool m_Persistent;
+    unsigned char* m_Mapped; // The whole buffer when persistent, the mapped range otherwise
+
+    std::vector<GLsync> m_Fences;
+    unsigned int m_Region;
+    unsigned int m_Offset;
+    unsigned int m_MapOffset;
+    bool m_IsMapped;
+
+    StreamBufferStats m_Stats;
+public:
+    /**
+        Create the buffer.
+
+        @param regionSize The size of a region in bytes, the largest amount of data a single Map can ask for
+        @param regionCount The amount of regions, three lets the CPU write a region while the GPU reads the two before it
+    */
+    StreamBuffer(unsigned int regionSize, unsigned int regionCount = 3);
+    ~StreamBuffer();
+
+    /**
+        Get memory to write vertices to. Everything that was written before must be drawn before the next Map,
+        the region it is in is fenced when the buffer moves past it.
+
+        @param size The largest amount of bytes that will be written
+        @param stride The size of a vertex, the memory starts at a whole vertex
+        @return The memory to write the vertices to
+    */
+    void* Map(unsigned int size, unsigned int stride);
+
+    /**
+        Finish writing, the vertices can be drawn afterwards.
+
+        @param size The amount of bytes that were actually written
+        @param stride The size of a vertex, the same as given to Map
+        @return The index of the first written vertex, the base vertex to draw them with
+    */
+    unsigned int Unmap(unsigned int size, unsigned int stride);
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline bool IsPersistent() const { return m_Persistent; }
+    inline const StreamBufferStats& GetStats() const { return m_Stats; }
+    inline void ResetStats() { m_Stats = StreamBufferStats(); }
+
+    void Bind() const;
+    void Unbind() const;
+private:
+
+    /**
+        Wait until the GPU is done with all draws that read from a region.
+    */
+    void WaitForRegion(unsigned int region);
+};
\ No newline at end of file
@@ -1,43 +1,124 @@
 #include "Texture.h"
+#include "TextureLoader.h"
+
+#include <algorithm>
 #include <iostream>
 
 #include "stb_image\stb_image.h"
 
-Texture::Texture(const std::string& path)
-    : m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
+Texture::Texture(const std::string& path, bool async)
+    : m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0), m_Pending(false)
 {
-    stbi_set_flip_vertically_on_load(1);
-    m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+    CreateTexture();
 
-    GLCall(glGenTextures(1, &m_RendererID));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    if (async)
+    {
+        // Grey stands out less than a missing texture color while a level streams in
+        unsigned char placeholder[] = { 128, 128, 128, 255 };
+        m_Width = 1;
+        m_Height = 1;
+        GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder));
+        GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, 0);
 
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        m_Pending = true;
+        TextureLoader::Get().Add(*this, path);
+        return;
+    }
+
+    m_LocalBuffer = LoadPixels(path, m_Width, m_Height, m_BPP);
 
     GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, 0);
 
     if (m_LocalBuffer)
     {
-        stbi_image_free(m_LocalBuffer);
+        FreePixels(m_LocalBuffer);
+        m_LocalBuffer = nullptr;
     }
 }
 
+Texture::Texture(int width, int height, unsigned int internalFormat)
+    : m_RendererID(0), m_LocalBuffer(nullptr), m_Width(width), m_Height(height), m_BPP(4), m_Pending(false)
+{
+    CreateTexture();
+
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr)); // Only allocate the storage
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D, 0);
+}
+
 Texture::~Texture()
 {
+    if (m_Pending)
+        TextureLoader::Get().Remove(*this);
+
+    GLStateCache::Get().OnDeleteTexture(m_RendererID);
     GLCall(glDeleteTextures(1, &m_RendererID));
 }
 
+void Texture::CreateTexture()
+{
+    GLCall(glGenTextures(1, &m_RendererID));
+    GLStateCache::Get().BindTextureForEdit(0, GL_TEXTURE_2D, m_RendererID);
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+}
+
+void Texture::FinishLoad(const unsigned char* pixels, int width, int height, int bpp)
+{
+    m_Pending = false;
+    if (!pixels)
+    {
+        std::cout << "Failed to load " << m_FilePath << ", the placeholder is kept" << std::endl;
+        return;
+    }
+
+    m_Width = width;
+    m_Height = height;
+    m_BPP = bpp;
+
+    // This happens between draws, so the texture that was bound to slot 0 is bound again afterwards
+    GLStateCache& cache = GLStateCache::Get();
+    unsigned int previous = cache.GetBoundTexture(0, GL_TEXTURE_2D);
+
+    cache.BindTextureForEdit(0, GL_TEXTURE_2D, m_RendererID);
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+    cache.BindTexture(0, GL_TEXTURE_2D, previous);
+}
+
+unsigned char* Texture::LoadPixels(const std::string& path, int& width, int& height, int& bpp)
+{
+    unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &bpp, 4);
+    if (!pixels)
+        return nullptr;
+
+    // stb_image only has a global flip setting that every thread would share, so the rows are flipped here
+    size_t rowSize = (size_t)width * 4;
+    for (int top = 0, bottom = height - 1; top < bottom; top++, bottom--)
+        std::swap_ranges(pixels + top * rowSize, pixels + (top + 1) * rowSize, pixels + bottom * rowSize);
+
+    return pixels;
+}
+
+void Texture::FreePixels(unsigned char* pixels)
+{
+    stbi_image_free(pixels);
+}
+
+void Texture::SetData(const unsigned char* pixels)
+{
+    GLStateCache::Get().BindTextureForEdit(0, GL_TEXTURE_2D, m_RendererID);
+    GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+}
+
 void Texture::Bind(unsigned int slot) const
 {
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    GLStateCache::Get().BindTexture(slot, GL_TEXTURE_2D, m_RendererID);
 }
 
-void Texture::Unbind()
+void Texture::Unbind(unsigned int slot)
 {
-    GLCall(glBindTexture(GL_TEXTURE_2D, 0));
+    GLStateCache::Get().BindTexture(slot, GL_TEXTURE_2D, 0);
 }
@@ -9,13 +9,69 @@ private:
     std::string m_FilePath;
     unsigned char* m_LocalBuffer;
     int m_Width, m_Height, m_BPP;
+    bool m_Pending;
 public:
-    Texture(const std::string& path);
+    /**
+        Load a texture from an image file.
+
+        @param path Path to the image file
+        @param async Decode the image on a worker thread, the texture shows a 1x1 grey placeholder until
+                     TextureLoader::Update uploads the pixels. The renderer ID stays the same, so the texture can be
+                     bound and drawn right away.
+    */
+    Texture(const std::string& path, bool async = false);
+
+    /**
+        Create an empty texture to render into.
+
+        @param width The width in pixels
+        @param height The height in pixels
+        @param internalFormat The format of the pixels, like GL_RGBA8 or GL_RGBA16F
+    */
+    Texture(int width, int height, unsigned int internalFormat = GL_RGBA8);
     ~Texture();
 
+    /**
+        Replace all pixels of the texture.
+
+        @param pixels RGBA pixels with 8 bits per channel, width * height * 4 bytes, starting at the bottom row
+    */
+    void SetData(const unsigned char* pixels);
+
     void Bind(unsigned int slot = 0) const;
-    void Unbind();
+    void Unbind(unsigned int slot = 0);
+
+    /**
+        Whether the pixels of the image are uploaded, the size is 1x1 until then.
+    */
+    inline bool IsReady() const { return !m_Pending; }
 
+    inline unsigned int GetRendererID() const { return m_RendererID; }
     inline int GetWidth() const { return m_Width; }
     inline int GetHeight() const { return m_Height; }
+
+    /**
+        Decode an image file into RGBA pixels starting at the bottom row, like OpenGL expects them.
+        This can be called from any thread, it doesn't touch the global flip setting of stb_image.
+
+        @param path Path to the image file
+        @param width Set to the width in pixels
+        @param height Set to the height in pixels
+        @param bpp Set to the amount of channels in the file, the pixels always have 4
+        @return The pixels, free them with FreePixels, or nullptr when the file couldn't be decoded
+    */
+    static unsigned char* LoadPixels(const std::string& path, int& width, int& height, int& bpp);
+    static void FreePixels(unsigned char* pixels);
+private:
+    friend class TextureLoader;
+
+    /**
+        Create the texture object with linear filtering and clamped edges, it's left bound to slot 0.
+    */
+    void CreateTexture();
+
+    /**
+        Replace the placeholder of an asynchronously loaded texture with the decoded pixels.
+    */
+    void FinishLoad(const unsigned char* pixels, int width, int height, int bpp);
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "TextureArray.h"
+#include <iostream>
+
+#include "Texture.h"
+
+TextureArray::TextureArray(int width, int height, unsigned int maxLayers)
+    : m_RendererID(0), m_Width(width), m_Height(height), m_MaxLayers(maxLayers), m_LayerCount(0)
+{
+    GLCall(glGenTextures(1, &m_RendererID));
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+    GLCall(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, m_Width, m_Height, m_MaxLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr)); // Only allocate the storage
+    GLStateCache::Get().BindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+}
+
+TextureArray::~TextureArray()
+{
+    GLStateCache::Get().OnDeleteTexture(m_RendererID);
+    GLCall(glDeleteTextures(1, &m_RendererID));
+}
+
+int TextureArray::AddLayer(const std::string& path)
+{
+    int width, height, bpp;
+    unsigned char* pixels = Texture::LoadPixels(path, width, height, bpp);
+
+    if (!pixels || width != m_Width || height != m_Height)
+    {
+        std::cout << "Failed to add " << path << " to the texture array, it has to be " << m_Width << "x" << m_Height << std::endl;
+        if (pixels)
+            Texture::FreePixels(pixels);
+        return -1;
+    }
+
+    int layer = AddLayer(pixels);
+    Texture::FreePixels(pixels);
+    return layer;
+}
+
+int TextureArray::AddLayer(const unsigned char* pixels)
+{
+    if (m_LayerCount == m_MaxLayers)
+        return -1;
+
+    GLStateCache::Get().BindTextureForEdit(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+    GLCall(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, m_LayerCount, m_Width, m_Height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+
+    return (int)m_LayerCount++;
+}
+
+void TextureArray::Bind(unsigned int slot) const
+{
+    GLStateCache::Get().BindTexture(slot, GL_TEXTURE_2D_ARRAY, m_RendererID);
+}
+
+void TextureArray::Unbind(unsigned int slot) const
+{
+    GLStateCache::Get().BindTexture(slot, GL_TEXTURE_2D_ARRAY, 0);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Renderer.h"
+
+/**
+Many images of the same size in a single GL_TEXTURE_2D_ARRAY, a shader picks the image with the layer index.
+Unlike an atlas every image keeps the full 0 to 1 texture coordinate range, so there is no bleeding between images.
+*/
+class TextureArray
+{
+private:
+    unsigned int m_RendererID;
+    int m_Width, m_Height;
+    unsigned int m_MaxLayers;
+    unsigned int m_LayerCount;
+public:
+    /**
+        Allocate the storage for all layers.
+
+        @param width The width every image has
+        @param height The height every image has
+        @param maxLayers The amount of images the array can hold
+    */
+    TextureArray(int width, int height, unsigned int maxLayers);
+    ~TextureArray();
+
+    /**
+        Load an image into the next free layer.
+
+        @param path The path of the image, it has to match the size of the array
+        @return The layer of the image, or -1 when it couldn't be loaded or doesn't fit
+    */
+    int AddLayer(const std::string& path);
+
+    /**
+        Upload an image into the next free layer.
+
+        @param pixels RGBA pixels with 8 bits per channel, width * height * 4 bytes, starting at the bottom row
+        @return The layer of the image, or -1 when the array is full
+    */
+    int AddLayer(const unsigned char* pixels);
+
+    void Bind(unsigned int slot = 0) const;
+    void Unbind(unsigned int slot = 0) const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+    inline unsigned int GetLayerCount() const { return m_LayerCount; }
+};
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <iostream>
+
+TextureAtlas::TextureAtlas(int pageSize, int padding, int extrude)
+    : m_PageSize(pageSize), m_Padding(padding), m_Extrude(std::min(extrude, padding / 2))
+{
+}
+
+int TextureAtlas::Add(const std::string& path)
+{
+    int width, height, bpp;
+    unsigned char* pixels = Texture::LoadPixels(path, width, height, bpp);
+
+    if (!pixels)
+    {
+        std::cout << "Failed to load " << path << " into the atlas" << std::endl;
+        return -1;
+    }
+
+    int sprite = Add(pixels, width, height);
+    Texture::FreePixels(pixels);
+    return sprite;
+}
+
+int TextureAtlas::Add(const unsigned char* pixels, int width, int height)
+{
+    ASSERT(width + m_Padding * 2 <= m_PageSize && height + m_Padding * 2 <= m_PageSize);
+
+    m_Images.push_back({ std::vector<unsigned char>(pixels, pixels + width * height * 4), width, height });
+    m_Regions.push_back({ 0, { 0.0f, 0.0f }, { 0.0f, 0.0f }, width, height });
+    return (int)m_Images.size() - 1;
+}
+
+void TextureAtlas::Build()
+{
+    // Place the tallest images first, the skyline stays flat that way
+    std::vector<unsigned int> order(m_Images.size());
+    for (unsigned int i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](unsigned int a, unsigned int b) { return m_Images[a].Height > m_Images[b].Height; });
+
+    ASSERT(m_Pages.empty()); // An atlas is built once
+
+    std::vector<std::vector<unsigned char>> pages;
+
+    for (unsigned int sprite : order)
+    {
+        const Image& image = m_Images[sprite];
+        int width = image.Width + m_Padding;
+        int height = image.Height + m_Padding;
+
+        // Use the first page it fits on, open a new page when it fits on none
+        int x = 0, y = 0, node = -1;
+        unsigned int page = 0;
+        for (; page < m_Skylines.size(); page++)
+        {
+            node = FindPosition(m_Skylines[page], width, height, x, y);
+            if (node >= 0)
+                break;
+        }
+
+        if (node < 0)
+        {
+            // The padding on the left and bottom of the page keeps the first sprites away from the edge as well
+            m_Skylines.push_back({ { m_Padding, m_Padding, m_PageSize - m_Padding } });
+            pages.emplace_back(m_PageSize * m_PageSize * 4, 0);
+            page = (unsigned int)m_Skylines.size() - 1;
+            node = FindPosition(m_Skylines[page], width, height, x, y);
+        }
+
+        AddSkylineLevel(m_Skylines[page], node, x, y, width, height);
+        CopyWithExtrusion(pages[page], image, x, y);
+
+        AtlasRegion& region = m_Regions[sprite];
+        region.Page = page;
+        region.UVMin = { (float)x / m_PageSize, (float)y / m_PageSize };
+        region.UVMax = { (float)(x + image.Width) / m_PageSize, (float)(y + image.Height) / m_PageSize };
+    }
+
+    for (const auto& pixels : pages)
+    {
+        m_Pages.emplace_back(new Texture(m_PageSize, m_PageSize));
+        m_Pages.back()->SetData(pixels.data());
+    }
+
+    m_Images.clear();
+}
+
+int TextureAtlas::FindPosition(const std::vector<SkylineNode>& skyline, int width, int height, int& x, int& y) const
+{
+    int bestIndex = -1;
+    int bestTop = m_PageSize + 1;
+    int bestWidth = m_PageSize + 1;
+
+    for (unsigned int i = 0; i < skyline.size(); i++)
+    {
+        int left = skyline[i].X;
+        if (left + width > m_PageSize)
+            break;
+
+        // The rectangle rests on the highest node below its width
+        int top = 0;
+        int remaining = width;
+        for (unsigned int j = i; remaining > 0; j++)
+        {
+            top = std::max(top, skyline[j].Y);
+            remaining -= skyline[j].Width;
+        }
+
+        if (top + height > m_PageSize)
+            continue;
+
+        // Prefer the lowest spot, then the narrowest node to waste the least space
+        if (top + height < bestTop || (top + height == bestTop && skyline[i].Width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top + height;
+            bestWidth = skyline[i].Width;
+            x = left;
+            y = top;
+        }
+    }
+
+    return bestIndex;
+}
+
+void TextureAtlas::AddSkylineLevel(std::vector<SkylineNode>& skyline, int index, int x, int y, int width, int height)
+{
+    skyline.insert(skyline.begin() + index, { x, y + height, width });
+
+    // Shrink or remove the nodes that are now covered by the new one
+    for (unsigned int i = index + 1; i < skyline.size(); i++)
+    {
+        const SkylineNode& previous = skyline[i - 1];
+        int overlap = previous.X + previous.Width - skyline[i].X;
+        if (overlap <= 0)
+            break;
+
+        skyline[i].X += overlap;
+        skyline[i].Width -= overlap;
+        if (skyline[i].Width > 0)
+            break;
+
+        skyline.erase(skyline.begin() + i);
+        i--;
+    }
+
+    // Merge neighbours at the same height
+    for (unsigned int i = 0; i + 1 < skyline.size(); i++)
+    {
+        if (skyline[i].Y == skyline[i + 1].Y)
+        {
+            skyline[i].Width += skyline[i + 1].Width;
+            skyline.erase(skyline.begin() + i + 1);
+            i--;
+        }
+    }
+}
+
+void TextureAtlas::CopyWithExtrusion(std::vector<unsigned char>& page, const Image& image, int x, int y) const
+{
+    // Repeating the edge pixels means linear filtering at the border of a sprite never samples its neighbour
+    for (int row = -m_Extrude; row < image.Height + m_Extrude; row++)
+    {
+        int sourceRow = std::min(std::max(row, 0), image.Height - 1);
+
+        for (int column = -m_Extrude; column < image.Width + m_Extrude; column++)
+        {
+            int sourceColumn = std::min(std::max(column, 0), image.Width - 1);
+
+            const unsigned char* source = &image.Pixels[(sourceRow * image.Width + sourceColumn) * 4];
+            unsigned char* destination = &page[((y + row) * m_PageSize + (x + column)) * 4];
+            std::copy(source, source + 4, destination);
+        }
+    }
+}
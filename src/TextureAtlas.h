@@ -0,0 +1,109 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Texture.h"
+
+#include "glm/glm.hpp"
+
+/**
+Where a sprite ended up in the atlas, the texture coordinates go straight into v_TexCoord.
+*/
+struct AtlasRegion
+{
+    unsigned int Page;
+    glm::vec2 UVMin; // bottom-left
+    glm::vec2 UVMax; // top-right
+    int Width, Height;
+};
+
+/**
+Packs many images into a few large textures, so sprites with different images can share a batch.
+Images are packed with a bottom-left skyline, which keeps pages dense for sprites of similar heights.
+*/
+class TextureAtlas
+{
+private:
+    /**
+        A horizontal segment of the top edge of everything that is packed on a page.
+    */
+    struct SkylineNode
+    {
+        int X, Y, Width;
+    };
+
+    struct Image
+    {
+        std::vector<unsigned char> Pixels;
+        int Width, Height;
+    };
+
+    int m_PageSize;
+    int m_Padding;
+    int m_Extrude;
+    std::vector<Image> m_Images;
+    std::vector<AtlasRegion> m_Regions;
+    std::vector<std::vector<SkylineNode>> m_Skylines;
+    std::vector<std::unique_ptr<Texture>> m_Pages;
+public:
+    /**
+        Create an empty atlas.
+
+        @param pageSize The width and height of every page in pixels
+        @param padding The amount of pixels between two sprites
+        @param extrude The amount of pixels the edges of a sprite are repeated into the padding, at most half the padding
+    */
+    TextureAtlas(int pageSize = 2048, int padding = 2, int extrude = 1);
+
+    /**
+        Add an image from a file.
+
+        @param path The path of the image
+        @return The index of the sprite, or -1 when the image couldn't be loaded
+    */
+    int Add(const std::string& path);
+
+    /**
+        Add an image from memory.
+
+        @param pixels RGBA pixels with 8 bits per channel, starting at the bottom row
+        @param width The width of the image
+        @param height The height of the image
+        @return The index of the sprite
+    */
+    int Add(const unsigned char* pixels, int width, int height);
+
+    /**
+        Pack all added images and upload the pages, the images are released afterwards. An atlas is built once.
+    */
+    void Build();
+
+    inline const AtlasRegion& GetRegion(int sprite) const { return m_Regions[sprite]; }
+    inline const Texture& GetPage(unsigned int page) const { return *m_Pages[page]; }
+    inline unsigned int GetPageCount() const { return (unsigned int)m_Pages.size(); }
+private:
+
+    /**
+        Find the lowest spot on a page where a rectangle fits.
+
+        @param skyline The skyline of the page
+        @param width The width of the rectangle
+        @param height The height of the rectangle
+        @param x The left of the spot
+        @param y The bottom of the spot
+        @return The index of the skyline node the spot starts at, or -1 when it doesn't fit
+    */
+    int FindPosition(const std::vector<SkylineNode>& skyline, int width, int height, int& x, int& y) const;
+
+    /**
+        Raise the skyline of a page over a rectangle placed at the given node.
+    */
+    void AddSkylineLevel(std::vector<SkylineNode>& skyline, int index, int x, int y, int width, int height);
+
+    /**
+        Copy an image into page pixels and repeat its edges into the padding around it.
+    */
+    void CopyWithExtrusion(std::vector<unsigned char>& page, const Image& image, int x, int y) const;
+};
\ No newline at end of file
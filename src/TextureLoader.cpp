@@ -0,0 +1,120 @@
+#include "TextureLoader.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <thread>
+
+/**
+One thread less than the hardware has, but at least one.
+*/
+static unsigned int GetDecodeThreadCount()
+{
+    unsigned int threads = std::thread::hardware_concurrency();
+    return threads > 1 ? threads - 1 : 1;
+}
+
+TextureLoader::TextureLoader()
+    : m_Pool(GetDecodeThreadCount())
+{
+}
+
+TextureLoader::~TextureLoader()
+{
+    // Wait for the jobs, they still lock the mutex when they finish
+    m_Pool.Wait();
+
+    for (const auto& load : m_Loads)
+    {
+        if (load->Pixels)
+            Texture::FreePixels(load->Pixels);
+    }
+}
+
+TextureLoader& TextureLoader::Get()
+{
+    static TextureLoader loader;
+    return loader;
+}
+
+unsigned int TextureLoader::Update()
+{
+    std::vector<std::shared_ptr<Load>> done;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto finished = std::stable_partition(m_Loads.begin(), m_Loads.end(), [](const std::shared_ptr<Load>& load) { return !load->Done; });
+        done.assign(finished, m_Loads.end());
+        m_Loads.erase(finished, m_Loads.end());
+    }
+
+    // Upload outside of the lock, so the workers can keep finishing loads
+    for (const auto& load : done)
+        Complete(*load);
+
+    return (unsigned int)m_Loads.size();
+}
+
+void TextureLoader::Finish(const Texture& texture)
+{
+    auto it = std::find_if(m_Loads.begin(), m_Loads.end(), [&texture](const std::shared_ptr<Load>& load) { return load->Target == &texture; });
+    if (it == m_Loads.end())
+        return;
+
+    std::shared_ptr<Load> load = *it;
+    m_Loads.erase(it);
+
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_LoadDone.wait(lock, [&load]() { return load->Done; });
+    }
+
+    Complete(*load);
+}
+
+void TextureLoader::FinishAll()
+{
+    m_Pool.Wait();
+    Update();
+}
+
+void TextureLoader::Add(Texture& texture, const std::string& path)
+{
+    auto load = std::make_shared<Load>(Load{ &texture, path, nullptr, 0, 0, 0, false });
+    m_Loads.push_back(load);
+
+    m_Pool.Submit([this, load]()
+    {
+        // Only the path and the pixels of the load are touched here, the texture belongs to the GL thread
+        unsigned char* pixels = Texture::LoadPixels(load->Path, load->Width, load->Height, load->BPP);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            load->Pixels = pixels;
+            load->Done = true;
+        }
+
+        m_LoadDone.notify_all();
+    });
+}
+
+void TextureLoader::Remove(const Texture& texture)
+{
+    // The load stays until it's decoded, then Update frees its pixels
+    for (const auto& load : m_Loads)
+    {
+        if (load->Target == &texture)
+            load->Target = nullptr;
+    }
+}
+
+void TextureLoader::Complete(Load& load)
+{
+    if (load.Target)
+        load.Target->FinishLoad(load.Pixels, load.Width, load.Height, load.BPP);
+
+    if (load.Pixels)
+    {
+        Texture::FreePixels(load.Pixels);
+        load.Pixels = nullptr;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+class Texture;
+
+/**
+Decodes the images of asynchronously loaded textures on worker threads and uploads them on the thread of the
+context. Decoding a large PNG takes milliseconds, so doing it in the render loop would stall the frame, while
+the upload is cheap and has to happen on the GL thread anyway. Call Update once per frame.
+*/
+class TextureLoader
+{
+private:
+    /**
+        A texture that is being decoded, the job and the loader share it so a deleted texture doesn't leave
+        the worker writing into freed memory.
+    */
+    struct Load
+    {
+        Texture* Target; // nullptr when the texture was deleted before its image was decoded
+        std::string Path;
+        unsigned char* Pixels;
+        int Width, Height, BPP;
+        bool Done; // Set by the worker, guarded by the mutex of the loader
+    };
+
+    std::vector<std::shared_ptr<Load>> m_Loads; // Only used by the GL thread
+    std::mutex m_Mutex;
+    std::condition_variable m_LoadDone;
+    ThreadPool m_Pool; // Declared last, so the workers are joined before the rest is destroyed
+public:
+    /**
+        Start the decoding threads, one less than the hardware has so the render thread keeps a core.
+    */
+    TextureLoader();
+    ~TextureLoader();
+
+    static TextureLoader& Get();
+
+    /**
+        Upload the textures that were decoded since the last call, call once per frame.
+
+        @return The amount of textures that are still decoding
+    */
+    unsigned int Update();
+
+    /**
+        Wait for a texture to be decoded and upload it.
+    */
+    void Finish(const Texture& texture);
+
+    /**
+        Wait for all textures, for example at the end of a loading screen.
+    */
+    void FinishAll();
+
+    inline unsigned int GetPendingCount() const { return (unsigned int)m_Loads.size(); }
+private:
+    friend class Texture;
+
+    void Add(Texture& texture, const std::string& path);
+    void Remove(const Texture& texture);
+
+    /**
+        Hand the pixels of a decoded load to its texture, or throw them away when the texture is gone.
+    */
+    void Complete(Load& load);
+};
\ No newline at end of file
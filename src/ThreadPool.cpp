@@ -0,0 +1,85 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : m_ActiveJobs(0), m_Stopping(false)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int i = 0; i < threadCount; i++)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+
+    m_JobAvailable.notify_all();
+    for (auto& worker : m_Workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Jobs.push(std::move(job));
+    }
+
+    m_JobAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobsDone.wait(lock, [this]() { return m_Jobs.empty() && m_ActiveJobs == 0; });
+}
+
+void ThreadPool::ParallelFor(unsigned int count, const std::function<void(unsigned int begin, unsigned int end, unsigned int chunk)>& function)
+{
+    unsigned int chunkCount = GetThreadCount();
+    unsigned int chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    for (unsigned int chunk = 0; chunk < chunkCount; chunk++)
+    {
+        unsigned int begin = std::min(count, chunk * chunkSize);
+        unsigned int end = std::min(count, begin + chunkSize);
+        Submit([&function, begin, end, chunk]() { function(begin, end, chunk); });
+    }
+
+    Wait();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_JobAvailable.wait(lock, [this]() { return m_Stopping || !m_Jobs.empty(); });
+
+            if (m_Stopping && m_Jobs.empty())
+                return;
+
+            job = std::move(m_Jobs.front());
+            m_Jobs.pop();
+            m_ActiveJobs++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_ActiveJobs--;
+            if (m_Jobs.empty() && m_ActiveJobs == 0)
+                m_JobsDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+A fixed set of worker threads for CPU work. None of the jobs may call OpenGL, the context belongs to the main thread.
+*/
+class ThreadPool
+{
+private:
+    std::vector<std::thread> m_Workers;
+    std::queue<std::function<void()>> m_Jobs;
+    std::mutex m_Mutex;
+    std::condition_variable m_JobAvailable;
+    std::condition_variable m_JobsDone;
+    unsigned int m_ActiveJobs;
+    bool m_Stopping;
+public:
+    /**
+        Start the worker threads.
+
+        @param threadCount The amount of workers, 0 to use one per hardware thread
+    */
+    ThreadPool(unsigned int threadCount = 0);
+    ~ThreadPool();
+
+    /**
+        Queue a job to run on one of the workers.
+    */
+    void Submit(std::function<void()> job);
+
+    /**
+        Block until every queued job has finished.
+    */
+    void Wait();
+
+    /**
+        Split a range in one chunk per worker, run the chunks in parallel and wait for them.
+
+        @param count The size of the range
+        @param function Called with the begin and end of a chunk and the index of the chunk
+    */
+    void ParallelFor(unsigned int count, const std::function<void(unsigned int begin, unsigned int end, unsigned int chunk)>& function);
+
+    inline unsigned int GetThreadCount() const { return (unsigned int)m_Workers.size(); }
+private:
+    void WorkerLoop();
+};
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "UniformBuffer.h"
+#include "Renderer.h"
+
+#include <cstring>
+
+unsigned int Std140Layout::Add(unsigned int alignment, unsigned int size, unsigned int count)
+{
+    // Every array element is padded to the alignment of a vec4
+    if (count > 1)
+    {
+        alignment = 16;
+        size = (size + 15) / 16 * 16;
+    }
+
+    unsigned int offset = (m_Size + alignment - 1) / alignment * alignment;
+    m_Size = offset + size * count;
+    return offset;
+}
+
+UniformBuffer::UniformBuffer(const std::string& blockName, unsigned int size)
+    : m_Binding(Shader::GetUniformBlockBinding(blockName)), m_Data(size)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+}
+
+UniformBuffer::~UniformBuffer()
+{
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+void UniformBuffer::Set(unsigned int offset, float value)
+{
+    SetData(offset, &value, sizeof(float));
+}
+
+void UniformBuffer::Set(unsigned int offset, int value)
+{
+    SetData(offset, &value, sizeof(int));
+}
+
+void UniformBuffer::Set(unsigned int offset, const glm::vec2& value)
+{
+    SetData(offset, &value[0], sizeof(glm::vec2));
+}
+
+void UniformBuffer::Set(unsigned int offset, const glm::vec3& value)
+{
+    SetData(offset, &value[0], sizeof(glm::vec3));
+}
+
+void UniformBuffer::Set(unsigned int offset, const glm::vec4& value)
+{
+    SetData(offset, &value[0], sizeof(glm::vec4));
+}
+
+void UniformBuffer::Set(unsigned int offset, const glm::mat4& value)
+{
+    // The columns of a glm matrix are packed vec4s, which is the std140 layout of a mat4
+    SetData(offset, &value[0][0], sizeof(glm::mat4));
+}
+
+void UniformBuffer::SetData(unsigned int offset, const void* data, unsigned int size)
+{
+    ASSERT(offset + size <= m_Data.size());
+
+    std::memcpy(&m_Data[offset], data, size);
+    m_DirtyRanges.Add(offset, size);
+}
+
+void UniformBuffer::Upload()
+{
+    if (m_DirtyRanges.IsEmpty())
+        return;
+
+    GLStateCache::Get().BindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    for (const DirtyRange& range : m_DirtyRanges.Merge())
+    {
+        GLCall(glBufferSubData(GL_UNIFORM_BUFFER, range.Offset, range.Size, &m_Data[range.Offset]));
+    }
+
+    m_DirtyRanges.Clear();
+}
+
+void UniformBuffer::Bind() const
+{
+    GLStateCache::Get().BindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "DirtyRangeList.h"
+
+#include "glm/glm.hpp"
+
+/**
+Computes the offsets of the members of a uniform block with the std140 rules, push the members in the order
+they are declared in the shader. Scalars align to 4 bytes, vec2 to 8, vec3, vec4 and matrix columns to 16,
+and every element of an array takes up a multiple of 16 bytes.
+*/
+class Std140Layout
+{
+private:
+    unsigned int m_Size;
+public:
+    Std140Layout()
+        : m_Size(0) {}
+
+    /**
+        Add a member to the block.
+
+        @param count The amount of elements, more than 1 for an array
+        @return The offset of the member in bytes
+    */
+    template<typename T>
+    unsigned int Push(unsigned int count = 1)
+    {
+        static_assert(sizeof(T) == 0, "This type has no std140 layout");
+        return 0;
+    }
+
+    /**
+        The size of the block, a multiple of 16 bytes like OpenGL reports for GL_UNIFORM_BLOCK_DATA_SIZE.
+    */
+    inline unsigned int GetSize() const { return (m_Size + 15) / 16 * 16; }
+private:
+    unsigned int Add(unsigned int alignment, unsigned int size, unsigned int count);
+};
+
+template<> inline unsigned int Std140Layout::Push<float>(unsigned int count) { return Add(4, 4, count); }
+template<> inline unsigned int Std140Layout::Push<int>(unsigned int count) { return Add(4, 4, count); }
+template<> inline unsigned int Std140Layout::Push<glm::vec2>(unsigned int count) { return Add(8, 8, count); }
+template<> inline unsigned int Std140Layout::Push<glm::vec3>(unsigned int count) { return Add(16, 12, count); }
+template<> inline unsigned int Std140Layout::Push<glm::vec4>(unsigned int count) { return Add(16, 16, count); }
+template<> inline unsigned int Std140Layout::Push<glm::mat4>(unsigned int count) { return Add(16, 64, count); }
+
+/**
+A buffer with the values of a uniform block, shared by every shader that declares a block with the same name.
+The values are written to a copy first and uploaded once with Upload, then every shader reads them after Bind.
+*/
+class UniformBuffer
+{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Binding;
+    std::vector<unsigned char> m_Data;
+    DirtyRangeList m_DirtyRanges;
+public:
+    /**
+        Create the buffer for a uniform block.
+
+        @param blockName The name of the block in the shaders, decides the binding point
+        @param size The size of the block in bytes, usually Std140Layout::GetSize
+    */
+    UniformBuffer(const std::string& blockName, unsigned int size);
+    ~UniformBuffer();
+
+    // Set a member at an offset from Std140Layout::Push
+    void Set(unsigned int offset, float value);
+    void Set(unsigned int offset, int value);
+    void Set(unsigned int offset, const glm::vec2& value);
+    void Set(unsigned int offset, const glm::vec3& value);
+    void Set(unsigned int offset, const glm::vec4& value);
+    void Set(unsigned int offset, const glm::mat4& value);
+
+    /**
+        Copy raw data into the block, the data must already follow the std140 layout.
+    */
+    void SetData(unsigned int offset, const void* data, unsigned int size);
+
+    /**
+        Upload the members that changed since the last upload.
+    */
+    void Upload();
+
+    /**
+        Bind the buffer to the binding point of its block.
+    */
+    void Bind() const;
+
+    inline unsigned int GetBinding() const { return m_Binding; }
+    inline unsigned int GetSize() const { return (unsigned int)m_Data.size(); }
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+};
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "UniformRingBuffer.h"
+#include "Renderer.h"
+
+#include <cstring>
+
+UniformRingBuffer::UniformRingBuffer(const std::string& blockName, unsigned int frameSize, unsigned int frameCount)
+    : m_Buffer(GetAlignedFrameSize(frameSize), frameCount), m_Binding(Shader::GetUniformBlockBinding(blockName)), m_Alignment(GetOffsetAlignment()),
+      m_MaxSize(0), m_Mapped(nullptr), m_Size(0), m_BaseOffset(0)
+{
+}
+
+void UniformRingBuffer::Begin(unsigned int size)
+{
+    ASSERT(!m_Mapped);
+
+    // Mapping with the alignment as stride puts the start of the memory on an aligned offset
+    m_Mapped = (unsigned char*)m_Buffer.Map(size, m_Alignment);
+    m_MaxSize = size;
+    m_Size = 0;
+}
+
+unsigned int UniformRingBuffer::Push(const void* data, unsigned int size)
+{
+    ASSERT(m_Mapped && m_Size + size <= m_MaxSize);
+
+    unsigned int offset = m_Size;
+    std::memcpy(m_Mapped + offset, data, size);
+    m_Size = offset + GetAlignedSize(size);
+    return offset;
+}
+
+void UniformRingBuffer::End()
+{
+    ASSERT(m_Mapped);
+
+    m_BaseOffset = m_Buffer.Unmap(m_Size, m_Alignment) * m_Alignment;
+    m_Mapped = nullptr;
+}
+
+void UniformRingBuffer::Bind(unsigned int handle, unsigned int size) const
+{
+    ASSERT(!m_Mapped); // The values are only visible to the GPU after End
+
+    GLStateCache::Get().BindBufferRange(GL_UNIFORM_BUFFER, m_Binding, m_Buffer.GetRendererID(), m_BaseOffset + handle, size);
+}
+
+unsigned int UniformRingBuffer::GetOffsetAlignment()
+{
+    int alignment;
+    GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    return (unsigned int)alignment;
+}
+
+unsigned int UniformRingBuffer::GetAlignedFrameSize(unsigned int frameSize)
+{
+    // Every region has to start on an aligned offset, or a frame that wraps doesn't fit after aligning its start
+    unsigned int alignment = GetOffsetAlignment();
+    return (frameSize + alignment - 1) / alignment * alignment;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+
+#include "StreamBuffer.h"
+
+/**
+Per draw values for a uniform block, like a model matrix and a color. The values of all draws are written
+into a ring of buffer memory at offsets that respect GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, and every draw binds
+its own range, which replaces a handful of glUniform calls per draw with a single glBindBufferRange.
+*/
+class UniformRingBuffer
+{
+private:
+    StreamBuffer m_Buffer;
+    unsigned int m_Binding;
+    unsigned int m_Alignment;
+    unsigned int m_MaxSize;
+
+    unsigned char* m_Mapped;
+    unsigned int m_Size; // The bytes written since Begin
+    unsigned int m_BaseOffset; // The offset of the mapped memory in the buffer, known after End
+public:
+    /**
+        Create the ring.
+
+        @param blockName The name of the uniform block in the shaders, decides the binding point
+        @param frameSize The most bytes that are written between a Begin and End, including the alignment padding
+        @param frameCount The amount of frames the GPU may lag behind before writing waits for it
+    */
+    UniformRingBuffer(const std::string& blockName, unsigned int frameSize, unsigned int frameCount = 3);
+
+    /**
+        Start writing the values of a set of draws.
+
+        @param size The most bytes that will be written, including the alignment padding, at most the frame size
+    */
+    void Begin(unsigned int size);
+
+    /**
+        Write the values of a single draw.
+
+        @param data The values, following the std140 layout of the block
+        @param size The size of the values in bytes
+        @return The handle to pass to Bind, valid from End until the next Begin
+    */
+    unsigned int Push(const void* data, unsigned int size);
+
+    template<typename T>
+    unsigned int Push(const T& values) { return Push(&values, sizeof(T)); }
+
+    /**
+        Finish writing, the values can be bound afterwards.
+    */
+    void End();
+
+    /**
+        Bind the values of a draw to the binding point of the block.
+
+        @param handle The handle Push returned
+        @param size The size of the values in bytes
+    */
+    void Bind(unsigned int handle, unsigned int size) const;
+
+    /**
+        The space a single draw takes up in the ring, its size rounded up to the alignment.
+    */
+    inline unsigned int GetAlignedSize(unsigned int size) const { return (size + m_Alignment - 1) / m_Alignment * m_Alignment; }
+    inline unsigned int GetAlignment() const { return m_Alignment; }
+    inline const StreamBuffer& GetBuffer() const { return m_Buffer; }
+private:
+    static unsigned int GetOffsetAlignment();
+
+    /**
+        The frame size rounded up to the alignment, used as the region size of the stream buffer.
+    */
+    static unsigned int GetAlignedFrameSize(unsigned int frameSize);
+};
\ No newline at end of file
@@ -1,14 +1,27 @@
 #include "VertexArray.h"
 #include "VertexBufferLayout.h"
+#include "StreamBuffer.h"
+#include "ShaderStorageBuffer.h"
 #include "Renderer.h"
 
+/**
+Hand out a new layout ID.
+*/
+static unsigned int NextLayoutID()
+{
+    static unsigned int layoutID = 0;
+    return ++layoutID;
+}
+
 VertexArray::VertexArray()
+    : m_LayoutID(NextLayoutID())
 {
     GLCall(glGenVertexArrays(1, &m_RendererID));
 }
 
 VertexArray::~VertexArray()
 {
+    GLStateCache::Get().OnDeleteVertexArray(m_RendererID);
     GLCall(glDeleteVertexArrays(1, &m_RendererID));
 }
 
@@ -16,25 +29,48 @@ void VertexArray::AddBuffer(const VertexBuffer & vb, const VertexBufferLayout &
 {
     Bind();
     vb.Bind();
+    AddAttributes(layout);
+}
+
+void VertexArray::AddBuffer(const StreamBuffer& sb, const VertexBufferLayout& layout)
+{
+    Bind();
+    sb.Bind();
+    AddAttributes(layout);
+}
 
+void VertexArray::AddBuffer(const ShaderStorageBuffer& sb, const VertexBufferLayout& layout)
+{
+    Bind();
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, sb.GetRendererID());
+    AddAttributes(layout);
+}
+
+void VertexArray::AddAttributes(const VertexBufferLayout& layout)
+{
     const auto& elements = layout.GetElements();
     unsigned int offset = 0;
 
     for (unsigned int i = 0; i < elements.size(); i++)
     {
         const auto& element = elements[i];
-        GLCall(glEnableVertexAttribArray(i));
-        GLCall(glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
+        unsigned int location = (unsigned int)m_Attributes.size();
+        GLCall(glEnableVertexAttribArray(location));
+        GLCall(glVertexAttribPointer(location, element.count, element.type, element.normalized, layout.GetStride(), (const void*)offset));
+        GLCall(glVertexAttribDivisor(location, layout.GetDivisor()));
         offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
+        m_Attributes.push_back({ element.type, element.count });
     }
+
+    m_LayoutID = NextLayoutID();
 }
 
 void VertexArray::Bind() const
 {
-    GLCall(glBindVertexArray(m_RendererID));
+    GLStateCache::Get().BindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
-    GLCall(glBindVertexArray(0));
+    GLStateCache::Get().BindVertexArray(0);
 }
@@ -1,19 +1,65 @@
 #pragma once
 
+#include <vector>
+
 #include "VertexBuffer.h"
 
 class VertexBufferLayout;
+class StreamBuffer;
+class ShaderStorageBuffer;
+
+/**
+The type of the data an attribute location of a vertex array reads.
+*/
+struct VertexAttribute
+{
+    unsigned int Type;
+    unsigned int Count;
+};
 
 class VertexArray
 {
 private:
     unsigned int m_RendererID;
+    std::vector<VertexAttribute> m_Attributes; // Indexed by location
+    unsigned int m_LayoutID;
 public:
     VertexArray();
     ~VertexArray();
 
+    /**
+        Attach a buffer, its attributes start at the location after the attributes of the previously added buffers.
+
+        @param vb The buffer with the vertex or instance data
+        @param layout The layout of the data in the buffer
+    */
     void AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
 
+    /**
+        Attach a stream buffer, draw its vertices with the base vertex that StreamBuffer::Unmap returns.
+    */
+    void AddBuffer(const StreamBuffer& sb, const VertexBufferLayout& layout);
+
+    /**
+        Attach a storage buffer, so the vertices or instances that a compute shader wrote are drawn without a copy.
+    */
+    void AddBuffer(const ShaderStorageBuffer& sb, const VertexBufferLayout& layout);
+
     void Bind() const;
     void Unbind() const;
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline const std::vector<VertexAttribute>& GetAttributes() const { return m_Attributes; }
+
+    /**
+        An ID of the current attributes, it changes when a buffer is added and is never reused by another vertex array.
+        Unlike the renderer ID, which OpenGL hands out again after a vertex array is deleted.
+    */
+    inline unsigned int GetLayoutID() const { return m_LayoutID; }
+private:
+
+    /**
+        Point the next attribute locations at the buffer that is bound to GL_ARRAY_BUFFER.
+    */
+    void AddAttributes(const VertexBufferLayout& layout);
 };
\ No newline at end of file
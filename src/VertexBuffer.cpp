@@ -1,24 +1,124 @@
 #include "VertexBuffer.h"
 #include "Renderer.h"
 
+#include <algorithm>
+#include <cstring>
+
 VertexBuffer::VertexBuffer(const void * data, unsigned int size)
+    : m_Size(size), m_DataSize(size), m_Dynamic(false)
 {
     GLCall(glGenBuffers(1, &m_RendererID)); // Generate a single buffer
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID)); // Select the buffer to be drawn
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID); // Select the buffer to be drawn
     GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW)); // Add the data to the buffer
 }
 
+VertexBuffer::VertexBuffer(unsigned int size)
+    : m_Size(size), m_DataSize(0), m_Dynamic(true), m_DirtyRanges(0)
+{
+    GLCall(glGenBuffers(1, &m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW)); // Only reserve the memory, the data follows later
+}
+
 VertexBuffer::~VertexBuffer()
 {
+    GLStateCache::Get().OnDeleteBuffer(m_RendererID);
     GLCall(glDeleteBuffers(1, &m_RendererID));  
 }
 
+void VertexBuffer::SetData(const void* data, unsigned int size)
+{
+    ASSERT(m_Dynamic);
+
+    // Streamed buffers never use SetSubData, so the data goes straight to the driver without a copy
+    m_Size = std::max(m_Size, size);
+    m_DataSize = size;
+    m_DirtyRanges.Clear(); // The pending changes are overwritten
+    if (!m_Data.empty())
+        m_Data.resize(m_Size);
+
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, m_Size, nullptr, GL_DYNAMIC_DRAW)); // Orphan the storage that may still be in use
+    GLCall(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+}
+
+void VertexBuffer::SetSubData(unsigned int offset, const void* data, unsigned int size)
+{
+    ASSERT(m_Dynamic && offset <= m_DataSize && offset + size <= m_Size);
+
+    if (m_Data.empty())
+        m_Data.resize(m_Size);
+
+    std::memcpy(&m_Data[offset], data, size);
+    m_DirtyRanges.Add(offset, size);
+    m_DataSize = std::max(m_DataSize, offset + size);
+}
+
+unsigned int VertexBuffer::Upload()
+{
+    if (m_DirtyRanges.IsEmpty())
+        return 0;
+
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+
+    unsigned int uploaded = 0;
+    for (const DirtyRange& range : m_DirtyRanges.Merge())
+    {
+        GLCall(glBufferSubData(GL_ARRAY_BUFFER, range.Offset, range.Size, &m_Data[range.Offset]));
+        uploaded += range.Size;
+    }
+
+    m_DirtyRanges.Clear();
+    return uploaded;
+}
+
+void VertexBuffer::Resize(unsigned int size)
+{
+    ASSERT(m_Dynamic);
+
+    // The pending changes are part of the data that is kept
+    Upload();
+
+    GLStateCache& cache = GLStateCache::Get();
+    unsigned int keep = std::min(m_DataSize, size);
+
+    // There is no copy of the data on the CPU, so it waits in a temporary buffer while the storage is replaced
+    unsigned int temporary = 0;
+    if (keep > 0)
+    {
+        GLCall(glGenBuffers(1, &temporary));
+        cache.BindBuffer(GL_COPY_WRITE_BUFFER, temporary);
+        GLCall(glBufferData(GL_COPY_WRITE_BUFFER, keep, nullptr, GL_STREAM_COPY));
+        cache.BindBuffer(GL_COPY_READ_BUFFER, m_RendererID);
+        GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, keep));
+    }
+
+    m_Size = size;
+    m_DataSize = keep;
+    if (!m_Data.empty())
+        m_Data.resize(size);
+
+    // New storage under the same name, vertex arrays that use the buffer stay valid
+    cache.BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    GLCall(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW));
+
+    if (temporary)
+    {
+        cache.BindBuffer(GL_COPY_READ_BUFFER, temporary);
+        cache.BindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID);
+        GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, keep));
+
+        cache.OnDeleteBuffer(temporary);
+        GLCall(glDeleteBuffers(1, &temporary));
+    }
+}
+
 void VertexBuffer::Bind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
 void VertexBuffer::Unbind() const
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    GLStateCache::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
 }
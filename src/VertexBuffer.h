@@ -1,13 +1,63 @@
 #pragma once
 
+#include <vector>
+
+#include "DirtyRangeList.h"
+
 class VertexBuffer
 {
 private:
     unsigned int m_RendererID;
+    unsigned int m_Size;
+    unsigned int m_DataSize; // The bytes at the start that hold data, the rest is undefined
+    bool m_Dynamic;
+    std::vector<unsigned char> m_Data; // SetSubData writes here until Upload, only allocated once SetSubData is used
+    DirtyRangeList m_DirtyRanges; // Never merges across a gap, only the bytes in m_Data that SetSubData wrote are valid
 public:
     VertexBuffer(const void* data, unsigned int size);
+
+    /**
+        Create an empty dynamic buffer that is filled later on with SetData or SetSubData.
+
+        @param size The size of the buffer in bytes
+    */
+    VertexBuffer(unsigned int size);
     ~VertexBuffer();
 
+    /**
+        Replace the contents of the buffer with new data and upload it right away. The old storage is orphaned first,
+        so the GPU can keep drawing from it while the new data is written. The buffer grows when the data doesn't fit,
+        and the bytes after the data are undefined afterwards.
+
+        @param data The vertices to upload
+        @param size The size of the data in bytes
+    */
+    void SetData(const void* data, unsigned int size);
+
+    /**
+        Change part of a dynamic buffer. Nothing is uploaded until Upload, so many small changes cost a few uploads.
+        The change has to start inside of or right after the data, so no undefined bytes are left in between.
+
+        @param offset The offset in bytes of the data in the buffer
+        @param data The new data
+        @param size The size of the data in bytes
+    */
+    void SetSubData(unsigned int offset, const void* data, unsigned int size);
+
+    /**
+        Upload the ranges of a dynamic buffer that were changed with SetSubData since the last upload.
+
+        @return The amount of bytes that were uploaded
+    */
+    unsigned int Upload();
+
+    /**
+        Change the size of a dynamic buffer, the data that fits in the new size is kept.
+    */
+    void Resize(unsigned int size);
+
+    inline unsigned int GetSize() const { return m_Size; }
+
     void Bind() const;
     void Unbind() const;
 };
\ No newline at end of file
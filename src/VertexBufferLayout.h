@@ -5,6 +5,8 @@
 
 #include "Renderer.h"
 
+#include "glm/glm.hpp"
+
 struct VertexBufferElement
 {
     unsigned int type;
@@ -30,9 +32,17 @@ class VertexBufferLayout
 private:
     std::vector<VertexBufferElement> m_Elements;
     unsigned int m_Stride;
+    unsigned int m_Divisor;
 public:
     VertexBufferLayout()
-        : m_Stride(0) {}
+        : m_Stride(0), m_Divisor(0) {}
+
+    /**
+        Advance the attributes of this layout per instance instead of per vertex.
+
+        @param divisor The amount of instances that share a value, 0 to advance per vertex
+    */
+    inline void SetDivisor(unsigned int divisor) { m_Divisor = divisor; }
 
     template<typename T>
     void Push(unsigned int count)
@@ -61,6 +71,15 @@ public:
         m_Stride += count * VertexBufferElement::GetSizeOfType(GL_UNSIGNED_BYTE);
     }
 
+    // A matrix takes up an attribute per column
+    template<>
+    void Push<glm::mat4>(unsigned int count)
+    {
+        for (unsigned int i = 0; i < count * 4; i++)
+            Push<float>(4);
+    }
+
     inline const std::vector<VertexBufferElement> GetElements() const { return m_Elements; }
     inline unsigned int GetStride() const { return m_Stride; }
+    inline unsigned int GetDivisor() const { return m_Divisor; }
 };
\ No newline at end of file